@@ -0,0 +1,30 @@
+#!/usr/bin/env bash
+# Runs the headless swing benchmark for every character count given (10 100 1000 by default).
+# Results are written to Saved/Benchmarks/SwingBenchmark_<Characters>_<Timestamp>.csv
+# With SWING_BENCHMARK_PROFILE=1 the measured frames are also captured to Saved/Profiling/CSV
+# and an Insights trace with the Swing channel is written to Saved/Profiling.
+#
+# Usage: UE4_ROOT=/path/to/UnrealEngine Scripts/RunSwingBenchmark.sh [Characters...]
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+UE4_EDITOR="${UE4_ROOT:?UE4_ROOT has to point to the engine root}/Engine/Binaries/Linux/UE4Editor"
+MAP="${SWING_BENCHMARK_MAP:-ThirdPersonExampleMap}"
+DURATION="${SWING_BENCHMARK_DURATION:-30}"
+PROFILE="${SWING_BENCHMARK_PROFILE:-0}"
+
+COUNTS=("$@")
+if [ ${#COUNTS[@]} -eq 0 ]; then
+	COUNTS=(10 100 1000)
+fi
+
+for COUNT in "${COUNTS[@]}"; do
+	PROFILE_ARGS=()
+	if [ "$PROFILE" = "1" ]; then
+		PROFILE_ARGS=(-trace=cpu,frame,Swing "-tracefile=$PROJECT_DIR/Saved/Profiling/SwingBenchmark_$COUNT.utrace")
+	fi
+
+	"$UE4_EDITOR" "$PROJECT_DIR/SwingProj.uproject" "$MAP?game=SwingBenchmark?Characters=$COUNT?Duration=$DURATION?Csv=$PROFILE" \
+		-game -nullrhi -nosound -unattended -nosplash -NoVerifyGC -log "${PROFILE_ARGS[@]+"${PROFILE_ARGS[@]}"}"
+done
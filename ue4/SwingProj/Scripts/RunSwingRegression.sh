@@ -0,0 +1,62 @@
+#!/usr/bin/env bash
+# Runs the headless swing regression scenarios and fails when one of them regresses past its baseline in Config/DefaultGame.ini.
+# Every scenario writes Saved/Benchmarks/Regression/SwingRegression_<Scenario>.json, the build machine archives that folder.
+# With SWING_REGRESSION_RECORD=1 regressions are not failures, the measured baselines are collected into
+# Saved/Benchmarks/Regression/Baselines.ini instead, ready to replace the ones in Config/DefaultGame.ini.
+#
+# Usage: UE4_ROOT=/path/to/UnrealEngine [SWING_REGRESSION_RECORD=1] Scripts/RunSwingRegression.sh [Scenarios...]
+
+set -uo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+UE4_EDITOR="${UE4_ROOT:?UE4_ROOT has to point to the engine root}/Engine/Binaries/Linux/UE4Editor"
+MAP="${SWING_BENCHMARK_MAP:-ThirdPersonExampleMap}"
+DURATION="${SWING_BENCHMARK_DURATION:-20}"
+REPORT_DIR="$PROJECT_DIR/Saved/Benchmarks/Regression"
+RECORD="${SWING_REGRESSION_RECORD:-0}"
+BASELINES_FILE="$REPORT_DIR/Baselines.ini"
+
+SCENARIOS=("$@")
+if [ ${#SCENARIOS[@]} -eq 0 ]; then
+	SCENARIOS=(SingleSwing ChainedSwings ThrowSpam ManyCharacters)
+fi
+
+mkdir -p "$REPORT_DIR"
+if [ "$RECORD" = "1" ]; then
+	: > "$BASELINES_FILE"
+fi
+
+FAILED=()
+for SCENARIO in "${SCENARIOS[@]}"; do
+	REPORT="$REPORT_DIR/SwingRegression_$SCENARIO.json"
+	LOG="$REPORT_DIR/SwingRegression_$SCENARIO.log"
+	rm -f "$REPORT"
+	"$UE4_EDITOR" "$PROJECT_DIR/SwingProj.uproject" "$MAP?game=SwingBenchmark?Scenario=$SCENARIO?Duration=$DURATION" \
+		-game -nullrhi -nosound -unattended -nosplash -NoVerifyGC -SwingCountAllocations -log | tee "$LOG"
+	EXIT_CODE=${PIPESTATUS[0]}
+
+	# A crash leaves no report, that counts as a failure in both modes
+	if [ ! -f "$REPORT" ]; then
+		FAILED+=("$SCENARIO")
+	elif [ "$RECORD" = "1" ]; then
+		MEASURED="$(grep -o '+RegressionBaselines=(Scenario='"$SCENARIO"',.*)' "$LOG" | tail -n 1)"
+		if [ -z "$MEASURED" ]; then
+			FAILED+=("$SCENARIO")
+		else
+			echo "$MEASURED" >> "$BASELINES_FILE"
+		fi
+	elif [ "$EXIT_CODE" -ne 0 ]; then
+		FAILED+=("$SCENARIO")
+	fi
+done
+
+if [ ${#FAILED[@]} -gt 0 ]; then
+	echo "Swing regression failed: ${FAILED[*]}" >&2
+	exit 1
+fi
+if [ "$RECORD" = "1" ]; then
+	echo "Swing baselines recorded to $BASELINES_FILE:"
+	cat "$BASELINES_FILE"
+else
+	echo "Swing regression passed: ${SCENARIOS[*]}"
+fi
@@ -2,68 +2,129 @@
 
 
 #include "InteractiveActor.h"
-#include "Characters/SwingProjCharacter.h"
-#include "Components/CapsuleComponent.h"
-#include "Components/SphereComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Recording/SPSwingRecording.h"
+#include "Subsystems/SPRopeAnchorSubsystem.h"
+#include "SwingProj.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interacting Interactive Actors"), STAT_InteractingInteractiveActors, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Interactive Actor Moved"), STAT_SwingInteractiveActorMoved, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Interaction Changed"), STAT_SwingInteractionChanged, STATGROUP_Swing);
 
 AInteractiveActor::AInteractiveActor()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Nothing to update per frame, interactions are only counted
+	PrimaryActorTick.bCanEverTick = false;
 	
 	/*AttachmentPoint = CreateDefaultSubobject<USceneComponent>(TEXT("AttachmentPoint"));
 	RootComponent = AttachmentPoint;
 
 	VisualMesh = CreateDefaultSubobject<UMeshComponent>(TEXT("Mesh"));
 	VisualMesh->SetupAttachment(RootComponent);*/
-	
-	//OverlapVolume->SetupAttachment(RootComponent);
+}
+
+void AInteractiveActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(AInteractiveActor, InteractionRadius);
 }
 
 void AInteractiveActor::BeginPlay()
 {
 	Super::BeginPlay();
-	if (IsValid(OverlapVolume))
+	StableId = FSPSwingRecordFrame::GetAnchorId(this);
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (IsValid(RopeAnchorSubsystem))
 	{
-		OverlapVolume->OnComponentBeginOverlap.AddDynamic(this, &AInteractiveActor::OnInteractionVolumeOverlapBegin);
-		OverlapVolume->OnComponentEndOverlap.AddDynamic(this, &AInteractiveActor::OnInteractionVolumeOverlapEnd);
+		RopeAnchorSubsystem->RegisterInteractiveActor(this);
+	}
+
+	// Static anchors never leave their cell, only movable ones report transform changes
+	if (IsValid(RootComponent) && RootComponent->Mobility == EComponentMobility::Movable)
+	{
+		RootComponent->TransformUpdated.AddUObject(this, &AInteractiveActor::OnRootTransformUpdated);
 	}
 }
 
-void AInteractiveActor::OnInteractionVolumeOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AInteractiveActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (!IsOverlappingCharacterCapsule(OtherActor, OtherComp))
+	if (IsInteracting())
 	{
-		return;
+		NumInteractors = 0;
+		OnInteractingChanged(false);
 	}
-	ASwingProjCharacter* CachedCharacter = StaticCast<ASwingProjCharacter*>(OtherActor);
-	CachedCharacter->RegisterInteractiveActor(this);
+
+	if (IsValid(RootComponent))
+	{
+		RootComponent->TransformUpdated.RemoveAll(this);
+	}
+
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (IsValid(RopeAnchorSubsystem))
+	{
+		RopeAnchorSubsystem->UnregisterInteractiveActor(this);
+	}
+	Super::EndPlay(EndPlayReason);
 }
 
-void AInteractiveActor::OnInteractionVolumeOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+void AInteractiveActor::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
 {
-	if (!IsOverlappingCharacterCapsule(OtherActor, OtherComp))
+	SCOPE_SWING_STAT(InteractiveActorMoved);
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (IsValid(RopeAnchorSubsystem))
 	{
-		return;
+		RopeAnchorSubsystem->UpdateInteractiveActorLocation(this);
 	}
-	ASwingProjCharacter* CachedCharacter = StaticCast<ASwingProjCharacter*>(OtherActor);
-	CachedCharacter->UnRegisterInteractiveActor(this);
 }
 
-bool AInteractiveActor::IsOverlappingCharacterCapsule(AActor* OtherActor, UPrimitiveComponent* OtherComp)
+void AInteractiveActor::SetInteractionRadius(float NewInteractionRadius)
 {
-	ASwingProjCharacter* CachedCharacter = Cast<ASwingProjCharacter>(OtherActor);
-	if (!IsValid(CachedCharacter))
+	InteractionRadius = NewInteractionRadius;
+
+	// The spatial hash caches the radius
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld() ? GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>() : nullptr;
+	if (SpatialHandle != INDEX_NONE && IsValid(RopeAnchorSubsystem))
 	{
-		return false;
+		RopeAnchorSubsystem->UpdateInteractiveActorRadius(this);
 	}
+}
 
-	if (Cast<UCapsuleComponent>(OtherComp) != CachedCharacter->GetCapsuleComponent())
+void AInteractiveActor::OnRep_InteractionRadius()
+{
+	SetInteractionRadius(InteractionRadius);
+}
+
+void AInteractiveActor::OnInteractionStarted(AActor* Interactor)
+{
+	if (NumInteractors++ == 0)
 	{
-		return false;
+		OnInteractingChanged(true);
+	}
+}
+
+void AInteractiveActor::OnInteractionEnded(AActor* Interactor)
+{
+	if (NumInteractors > 0 && --NumInteractors == 0)
+	{
+		OnInteractingChanged(false);
 	}
-	
-	return true;
 }
 
+void AInteractiveActor::OnInteractingChanged(bool bIsInteracting)
+{
+	SCOPE_SWING_STAT(InteractionChanged);
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (IsValid(RopeAnchorSubsystem))
+	{
+		RopeAnchorSubsystem->OnInteractiveActorInteractingChanged(bIsInteracting);
+	}
 
+	if (bIsInteracting)
+	{
+		INC_DWORD_STAT(STAT_InteractingInteractiveActors);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_InteractingInteractiveActors);
+	}
+}
@@ -6,27 +6,56 @@
 #include "GameFramework/Actor.h"
 #include "InteractiveActor.generated.h"
 
+enum class EInteractiveActorType : uint8
+{
+	None = 0,
+	RopeSwingAttachment
+};
+
 UCLASS()
 class SWINGPROJ_API AInteractiveActor : public AActor
 {
 	GENERATED_BODY()
+
+	friend class USPRopeAnchorSubsystem;
 	
 public:	
 	// Sets default values for this actor's properties
 	AInteractiveActor();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	float GetInteractionRadius() const { return InteractionRadius; }
+	void SetInteractionRadius(float NewInteractionRadius);
+
+	virtual EInteractiveActorType GetInteractiveActorType() const { return EInteractiveActorType::None; }
+
+	// Counts the characters interacting with the actor, e.g. hanging on it
+	void OnInteractionStarted(AActor* Interactor);
+	void OnInteractionEnded(AActor* Interactor);
+
+	bool IsInteracting() const { return NumInteractors > 0; }
+
+	// Hash of the actor path, the same in every process that loads the map. Set in BeginPlay
+	uint32 GetStableId() const { return StableId; }
+
 protected:
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	class UPrimitiveComponent* OverlapVolume;
+	// Characters closer than this can interact with the actor, looked up through USPRopeAnchorSubsystem
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_InteractionRadius, Category = Interaction, meta = (ClampMin = "0", UIMin = "0"))
+	float InteractionRadius = 200.f;
+
+	UFUNCTION()
+	void OnRep_InteractionRadius();
 	
 	virtual void BeginPlay() override;
-	
-	UFUNCTION()
-	virtual void OnInteractionVolumeOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	UFUNCTION()
-	virtual void OnInteractionVolumeOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+private:
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
 
-	bool IsOverlappingCharacterCapsule(AActor* OtherActor, UPrimitiveComponent* OtherComp);
+	void OnInteractingChanged(bool bIsInteracting);
 
+	int32 SpatialHandle = INDEX_NONE;
+	int32 NumInteractors = 0;
+	uint32 StableId = 0;
 };
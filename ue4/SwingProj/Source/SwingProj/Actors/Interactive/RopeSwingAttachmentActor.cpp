@@ -2,7 +2,7 @@
 
 
 #include "RopeSwingAttachmentActor.h"
-#include "Components/SphereComponent.h"
+#include "Components/StaticMeshComponent.h"
 
 ARopeSwingAttachmentActor::ARopeSwingAttachmentActor()
 {
@@ -10,10 +10,76 @@ ARopeSwingAttachmentActor::ARopeSwingAttachmentActor()
 
 	MeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AttacmentMesh"));
 	MeshComponent -> SetupAttachment(RootComponent);
-	
-	OverlapVolume = CreateDefaultSubobject<USphereComponent>(TEXT("OverlapVolume"));
-	OverlapVolume->SetupAttachment(RootComponent);
-	OverlapVolume->SetCollisionProfileName(FName("PawnInteractionVolume"));
-	OverlapVolume->SetGenerateOverlapEvents(true);
-	
+}
+
+void ARopeSwingAttachmentActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bUseInstancedVisual && IsValid(MeshComponent) && MeshComponent->GetStaticMesh() != nullptr)
+	{
+		// A hidden component has no scene proxy, its collision and transform are kept
+		MeshComponent->SetVisibility(false);
+		if (MeshComponent->Mobility == EComponentMobility::Movable)
+		{
+			MeshComponent->TransformUpdated.AddUObject(this, &ARopeSwingAttachmentActor::OnMeshTransformUpdated);
+		}
+		UpdateInstancedVisual();
+	}
+}
+
+void ARopeSwingAttachmentActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsValid(MeshComponent))
+	{
+		MeshComponent->TransformUpdated.RemoveAll(this);
+	}
+
+	USPAnchorVisualSubsystem* AnchorVisualSubsystem = GetWorld()->GetSubsystem<USPAnchorVisualSubsystem>();
+	if (VisualHandle.IsValid() && IsValid(AnchorVisualSubsystem))
+	{
+		AnchorVisualSubsystem->RemoveInstance(VisualHandle);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void ARopeSwingAttachmentActor::SetActorHiddenInGame(bool bNewHidden)
+{
+	Super::SetActorHiddenInGame(bNewHidden);
+	UpdateInstancedVisual();
+}
+
+void ARopeSwingAttachmentActor::PostNetReceive()
+{
+	Super::PostNetReceive();
+	// Pooled anchors are hidden and shown by the server
+	UpdateInstancedVisual();
+}
+
+void ARopeSwingAttachmentActor::UpdateInstancedVisual()
+{
+	USPAnchorVisualSubsystem* AnchorVisualSubsystem = GetWorld() ? GetWorld()->GetSubsystem<USPAnchorVisualSubsystem>() : nullptr;
+	if (!HasActorBegunPlay() || !bUseInstancedVisual || !IsValid(AnchorVisualSubsystem))
+	{
+		return;
+	}
+
+	const bool bWantsInstance = !IsHidden() && IsValid(MeshComponent) && MeshComponent->GetStaticMesh() != nullptr;
+	if (bWantsInstance && !VisualHandle.IsValid())
+	{
+		VisualHandle = AnchorVisualSubsystem->AddInstance(MeshComponent, MeshComponent->GetComponentTransform());
+	}
+	else if (!bWantsInstance && VisualHandle.IsValid())
+	{
+		AnchorVisualSubsystem->RemoveInstance(VisualHandle);
+	}
+}
+
+void ARopeSwingAttachmentActor::OnMeshTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	USPAnchorVisualSubsystem* AnchorVisualSubsystem = GetWorld()->GetSubsystem<USPAnchorVisualSubsystem>();
+	if (VisualHandle.IsValid() && IsValid(AnchorVisualSubsystem))
+	{
+		AnchorVisualSubsystem->UpdateInstanceTransform(VisualHandle, MeshComponent->GetComponentTransform());
+	}
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "InteractiveActor.h"
+#include "Subsystems/SPAnchorVisualSubsystem.h"
 #include "RopeSwingAttachmentActor.generated.h"
 
 /**
@@ -19,12 +20,29 @@ class SWINGPROJ_API ARopeSwingAttachmentActor : public AInteractiveActor
 public:
 	ARopeSwingAttachmentActor();
 
+	virtual EInteractiveActorType GetInteractiveActorType() const override { return EInteractiveActorType::RopeSwingAttachment; }
+
+	virtual void SetActorHiddenInGame(bool bNewHidden) override;
+	virtual void PostNetReceive() override;
+
+	// Keeps its transform and collision while the mesh is drawn through the visual handle
 	UStaticMeshComponent* GetMesh() const { return MeshComponent; };
+	const FSPAnchorVisualHandle& GetVisualHandle() const { return VisualHandle; }
 	
 protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	UStaticMeshComponent* MeshComponent;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	float OverlapVolumeRadius = 200.f;
+	// Draws the mesh as an instance shared with all anchors of the same mesh, see USPAnchorVisualSubsystem
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rendering)
+	bool bUseInstancedVisual = true;
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void UpdateInstancedVisual();
+	void OnMeshTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	FSPAnchorVisualHandle VisualHandle;
 };
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPAnchorDataActor.h"
+
+#include "RopeSwingAttachmentActor.h"
+#include "Subsystems/SPRopeAnchorSubsystem.h"
+
+ASPAnchorDataActor::ASPAnchorDataActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+
+	AnchorClass = ARopeSwingAttachmentActor::StaticClass();
+}
+
+EInteractiveActorType ASPAnchorDataActor::GetAnchorType() const
+{
+	return AnchorClass != nullptr ? AnchorClass.GetDefaultObject()->GetInteractiveActorType() : EInteractiveActorType::None;
+}
+
+FTransform ASPAnchorDataActor::GetRecordTransform(int32 Index) const
+{
+	const FSPAnchorRecord& Record = Records[Index];
+	return FTransform(Record.Rotation, Record.Location) * GetActorTransform();
+}
+
+void ASPAnchorDataActor::BeginPlay()
+{
+	Super::BeginPlay();
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (IsValid(RopeAnchorSubsystem))
+	{
+		RopeAnchorSubsystem->RegisterAnchorData(this);
+	}
+}
+
+void ASPAnchorDataActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (IsValid(RopeAnchorSubsystem))
+	{
+		RopeAnchorSubsystem->UnregisterAnchorData(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
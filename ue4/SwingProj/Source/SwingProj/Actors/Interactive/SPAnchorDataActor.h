@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "InteractiveActor.h"
+#include "SPAnchorDataActor.generated.h"
+
+USTRUCT()
+struct FSPAnchorRecord
+{
+	GENERATED_BODY()
+
+	// Relative to the data actor
+	UPROPERTY(EditAnywhere, meta = (MakeEditWidget = true))
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere)
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+	float InteractionRadius = 200.f;
+};
+
+/**
+ * Anchors of one streaming level stored as plain records, they live in USPRopeAnchorSubsystem while the level is loaded.
+ * An actor of AnchorClass is only taken from the subsystem's pool while a pawn is in range of a record.
+ */
+UCLASS()
+class SWINGPROJ_API ASPAnchorDataActor : public AActor
+{
+	GENERATED_BODY()
+
+	friend class USPRopeAnchorSubsystem;
+
+public:
+	ASPAnchorDataActor();
+
+	TSubclassOf<AInteractiveActor> GetAnchorClass() const { return AnchorClass; }
+	EInteractiveActorType GetAnchorType() const;
+
+	int32 GetNumRecords() const { return Records.Num(); }
+	const FSPAnchorRecord& GetRecord(int32 Index) const { return Records[Index]; }
+	FTransform GetRecordTransform(int32 Index) const;
+
+protected:
+	UPROPERTY(EditAnywhere, Category = Anchors)
+	TSubclassOf<AInteractiveActor> AnchorClass;
+
+	UPROPERTY(EditAnywhere, Category = Anchors)
+	TArray<FSPAnchorRecord> Records;
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// Spatial hash entries of the records while registered
+	TArray<int32> EntryHandles;
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPCountingMalloc.h"
+
+TAtomic<uint64> FSPCountingMalloc::NumGameThreadAllocations { 0 };
+bool FSPCountingMalloc::bIsInstalled = false;
+
+void FSPCountingMalloc::Install()
+{
+	check(IsInGameThread());
+	if (bIsInstalled || GMalloc == nullptr)
+	{
+		return;
+	}
+
+	bIsInstalled = true;
+	FMalloc* CountingMalloc = new FSPCountingMalloc(GMalloc);
+	FPlatformAtomics::InterlockedExchangePtr((void**)&GMalloc, CountingMalloc);
+}
+
+void* FSPCountingMalloc::Malloc(SIZE_T Count, uint32 Alignment)
+{
+	if (IsInGameThread())
+	{
+		++NumGameThreadAllocations;
+	}
+	return InnerMalloc->Malloc(Count, Alignment);
+}
+
+void* FSPCountingMalloc::Realloc(void* Original, SIZE_T Count, uint32 Alignment)
+{
+	// A shrink to zero is a free
+	if (Count > 0 && IsInGameThread())
+	{
+		++NumGameThreadAllocations;
+	}
+	return InnerMalloc->Realloc(Original, Count, Alignment);
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+#include "Templates/Atomic.h"
+
+/**
+ * Forwards to the previous GMalloc and counts the allocations made on the game thread.
+ * Installed at module startup when the command line has -SwingCountAllocations and never removed,
+ * blocks allocated before and after share the same allocator.
+ */
+class SWINGPROJ_API FSPCountingMalloc final : public FMalloc
+{
+public:
+	static void Install();
+	static bool IsInstalled() { return bIsInstalled; }
+
+	// Zero unless installed
+	static uint64 GetNumGameThreadAllocations() { return NumGameThreadAllocations.Load(EMemoryOrder::Relaxed); }
+
+	explicit FSPCountingMalloc(FMalloc* InInnerMalloc)
+		: InnerMalloc(InInnerMalloc)
+	{
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override;
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+	virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void InitializeStatsMetadata() override { InnerMalloc->InitializeStatsMetadata(); }
+	virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+
+private:
+	FMalloc* InnerMalloc;
+
+	static TAtomic<uint64> NumGameThreadAllocations;
+	static bool bIsInstalled;
+};
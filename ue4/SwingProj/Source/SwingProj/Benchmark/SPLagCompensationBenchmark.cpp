@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Simulation/SPPoseHistory.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLagCompensationBenchmark, Log, All);
+
+namespace SPLagCompensationBenchmark
+{
+	static constexpr float MoveTime = 1.f / 60.f;
+	static constexpr float MaxPing = 0.3f;
+
+	void Run(const TArray<FString>& Args)
+	{
+		const int32 NumPlayers = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100;
+		const int32 ThrowsPerPlayer = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1000;
+
+		// Every player runs and turns for longer than its history holds
+		FRandomStream RandomStream(0);
+		TArray<FSPPoseHistory> Histories;
+		Histories.SetNum(NumPlayers);
+		for (FSPPoseHistory& History : Histories)
+		{
+			FVector Location = RandomStream.VRand() * 10000.f;
+			FRotator ViewRotation(RandomStream.FRandRange(-30.f, 30.f), RandomStream.FRandRange(-180.f, 180.f), 0.f);
+			const FVector Velocity = RandomStream.VRand() * 600.f;
+			for (int32 Move = 0; Move < FSPPoseHistory::Capacity * 2; ++Move)
+			{
+				Location += Velocity * MoveTime;
+				ViewRotation.Yaw += RandomStream.FRandRange(-2.f, 2.f);
+				History.Add(Move * MoveTime, Location, ViewRotation);
+			}
+		}
+
+		// Half of the claims are honest throws at an anchor the player looked at, the rest point behind it
+		const int32 NumThrows = NumPlayers * ThrowsPerPlayer;
+		TArray<FSPSwingAttachClaim> Claims;
+		Claims.SetNum(NumThrows);
+		FSPSwingAttachValidationParams Params;
+		Params.MaxRewindTime = MaxPing + 0.1f;
+		for (int32 Throw = 0; Throw < NumThrows; ++Throw)
+		{
+			const FSPPoseHistory& History = Histories[Throw % NumPlayers];
+			FSPSwingAttachClaim& Claim = Claims[Throw];
+			const float AnchorDistance = RandomStream.FRandRange(200.f, 900.f);
+			Claim.AttachTimeStamp = History.GetNewestTimeStamp() - RandomStream.FRandRange(0.f, MaxPing);
+			Claim.ThrowTimeStamp = Claim.AttachTimeStamp - AnchorDistance / Params.HookSpeed;
+			Claim.InteractionRadius = 1000.f;
+
+			FVector ThrowLocation;
+			FVector ViewDirection;
+			History.Sample(Claim.ThrowTimeStamp, ThrowLocation, ViewDirection);
+			const bool bIsHonest = RandomStream.FRand() < 0.5f;
+			Claim.AnchorLocation = ThrowLocation + (bIsHonest ? ViewDirection : -ViewDirection) * AnchorDistance;
+
+			FVector AttachLocation;
+			History.Sample(Claim.AttachTimeStamp, AttachLocation, ViewDirection);
+			Claim.RopeLength = FVector::Dist(Claim.AnchorLocation, AttachLocation);
+		}
+
+		// Throws of different players are interleaved, as they would arrive on a busy server
+		int32 NumVerdicts[3] = {};
+		float RopeLength = 0.f;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Throw = 0; Throw < NumThrows; ++Throw)
+		{
+			const ESPSwingAttachVerdict Verdict = FSPSwingAttachValidator::Validate(Histories[Throw % NumPlayers], Claims[Throw], Params, RopeLength);
+			NumVerdicts[(int32)Verdict]++;
+		}
+		const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogLagCompensationBenchmark, Display, TEXT("Lag compensation: %d players, %d throws in %.2f ms, %.1f ns/throw, %d accepted, %d corrected, %d rejected, %d bytes of history per player"),
+			NumPlayers, NumThrows, ElapsedTime * 1000.0, ElapsedTime * 1e9 / NumThrows,
+			NumVerdicts[(int32)ESPSwingAttachVerdict::Accepted], NumVerdicts[(int32)ESPSwingAttachVerdict::Corrected], NumVerdicts[(int32)ESPSwingAttachVerdict::Rejected],
+			(int32)sizeof(FSPPoseHistory));
+	}
+}
+
+static FAutoConsoleCommand LagCompensationBenchmarkCommand(
+	TEXT("Swing.LagCompensationBenchmark"),
+	TEXT("Validates [ThrowsPerPlayer=1000] rewound rope attaches for each of [NumPlayers=100] players with synthetic pose histories"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SPLagCompensationBenchmark::Run));
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingBenchmarkAIController.h"
+
+#include "Actors/Interactive/InteractiveActor.h"
+#include "Characters/SwingProjCharacter.h"
+#include "Components/MovementComponents/SPSwingReleasePredictorComponent.h"
+#include "Subsystems/SPRopeAnchorSubsystem.h"
+
+ASPSwingBenchmarkAIController::ASPSwingBenchmarkAIController()
+{
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void ASPSwingBenchmarkAIController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ASwingProjCharacter* SwingCharacter = Cast<ASwingProjCharacter>(GetPawn());
+	if (!IsValid(SwingCharacter))
+	{
+		return;
+	}
+
+	StateTime += DeltaTime;
+	switch (State)
+	{
+		case ESPSwingBenchmarkState::Idle:
+		{
+			if (StateTime < StateDuration || (!bChainSwings && SwingCharacter->GetCharacterMovement()->IsFalling()))
+			{
+				break;
+			}
+
+			AInteractiveActor* Anchor = FindNearestAnchor();
+			if (!IsValid(Anchor))
+			{
+				SetState(ESPSwingBenchmarkState::Idle, MaxIdleTime);
+				break;
+			}
+
+			// The camera boom follows the control rotation on its next update, the throw happens one frame later
+			SetControlRotation((Anchor->GetActorLocation() - SwingCharacter->GetActorLocation()).Rotation());
+			SetState(ESPSwingBenchmarkState::Aiming);
+			break;
+		}
+		case ESPSwingBenchmarkState::Aiming:
+		{
+			SwingCharacter->ThrowRope();
+			SetState(ESPSwingBenchmarkState::Throwing, ThrowTimeout);
+			break;
+		}
+		case ESPSwingBenchmarkState::Throwing:
+		{
+			// The hook projectile attaches the character on contact
+			if (SwingCharacter->IsSwinging())
+			{
+				SetState(ESPSwingBenchmarkState::Swinging, RandomStream.FRandRange(MinSwingTime, MaxSwingTime));
+			}
+			else if (StateTime >= StateDuration)
+			{
+				SetState(ESPSwingBenchmarkState::Idle, RandomStream.FRandRange(MinIdleTime, MaxIdleTime));
+			}
+			break;
+		}
+		case ESPSwingBenchmarkState::Swinging:
+		{
+			// Lets go early once the release is predicted to land on walkable ground
+			const FSPSwingReleasePrediction& Prediction = SwingCharacter->GetSwingReleasePredictor()->GetLatestPrediction();
+			const bool bHasSafeLanding = StateTime >= MinSwingTime && Prediction.bIsValid && Prediction.bHasLanding && Prediction.LandingNormal.Z >= SafeLandingMinNormalZ;
+			if (StateTime >= StateDuration || bHasSafeLanding || !SwingCharacter->IsSwinging())
+			{
+				SwingCharacter->Jump();
+				SwingCharacter->StopJumping();
+				SetState(ESPSwingBenchmarkState::Idle, RandomStream.FRandRange(MinIdleTime, MaxIdleTime));
+			}
+			break;
+		}
+	}
+}
+
+void ASPSwingBenchmarkAIController::SetCycleTimes(float InMinIdleTime, float InMaxIdleTime, float InMinSwingTime, float InMaxSwingTime, bool bInChainSwings)
+{
+	MinIdleTime = InMinIdleTime;
+	MaxIdleTime = InMaxIdleTime;
+	MinSwingTime = InMinSwingTime;
+	MaxSwingTime = InMaxSwingTime;
+	bChainSwings = bInChainSwings;
+}
+
+void ASPSwingBenchmarkAIController::SetState(ESPSwingBenchmarkState NewState, float NewStateDuration)
+{
+	State = NewState;
+	StateTime = 0.f;
+	StateDuration = NewStateDuration;
+}
+
+AInteractiveActor* ASPSwingBenchmarkAIController::FindNearestAnchor() const
+{
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (!IsValid(RopeAnchorSubsystem))
+	{
+		return nullptr;
+	}
+
+	const FVector PawnLocation = GetPawn()->GetActorLocation();
+	AnchorQueryResults.Reset();
+	RopeAnchorSubsystem->QueryInRadius(PawnLocation, AnchorSearchRadius, AnchorQueryResults);
+
+	AInteractiveActor* NearestAnchor = nullptr;
+	float NearestDistanceSquared = MAX_flt;
+	for (AInteractiveActor* Anchor : AnchorQueryResults)
+	{
+		const float DistanceSquared = FVector::DistSquared(Anchor->GetActorLocation(), PawnLocation);
+		if (Anchor->GetInteractiveActorType() == EInteractiveActorType::RopeSwingAttachment && DistanceSquared < NearestDistanceSquared)
+		{
+			NearestDistanceSquared = DistanceSquared;
+			NearestAnchor = Anchor;
+		}
+	}
+	return NearestAnchor;
+}
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "SPSwingBenchmarkAIController.generated.h"
+
+class AInteractiveActor;
+
+UENUM()
+enum class ESPSwingBenchmarkState : uint8
+{
+	Idle,
+	Aiming,
+	Throwing,
+	Swinging
+};
+
+/**
+ * Drives a character through an endless throw - attach - swing - jump cycle for the swing benchmark
+ */
+UCLASS()
+class SWINGPROJ_API ASPSwingBenchmarkAIController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	ASPSwingBenchmarkAIController();
+
+	virtual void Tick(float DeltaTime) override;
+
+	void SetRandomSeed(int32 Seed) { RandomStream.Initialize(Seed); }
+
+	// Scripted scenarios shorten the cycle, with bInChainSwings the next rope is thrown while still in the air
+	void SetCycleTimes(float InMinIdleTime, float InMaxIdleTime, float InMinSwingTime, float InMaxSwingTime, bool bInChainSwings);
+
+protected:
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float MinIdleTime = 0.2f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float MaxIdleTime = 1.f;
+
+	// A throw whose hook has not attached by then is given up
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float ThrowTimeout = 1.5f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float MinSwingTime = 1.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float MaxSwingTime = 3.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float AnchorSearchRadius = 800.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float SafeLandingMinNormalZ = 0.7f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	bool bChainSwings = false;
+
+private:
+	void SetState(ESPSwingBenchmarkState NewState, float NewStateDuration = 0.f);
+	AInteractiveActor* FindNearestAnchor() const;
+
+	ESPSwingBenchmarkState State = ESPSwingBenchmarkState::Idle;
+	float StateTime = 0.f;
+	float StateDuration = 0.f;
+
+	FRandomStream RandomStream;
+	mutable TArray<AInteractiveActor*> AnchorQueryResults;
+};
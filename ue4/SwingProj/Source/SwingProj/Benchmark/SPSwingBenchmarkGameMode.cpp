@@ -0,0 +1,378 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingBenchmarkGameMode.h"
+
+#include "Actors/Interactive/RopeSwingAttachmentActor.h"
+#include "Benchmark/SPCountingMalloc.h"
+#include "Characters/SwingProjCharacter.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "HAL/PlatformMemory.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "RenderCore.h"
+#include "SPSwingBenchmarkAIController.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSwingBenchmark, Log, All);
+
+namespace SPSwingBenchmark
+{
+	// Nearest rank percentile of an ascending array
+	static float GetPercentile(const TArray<float>& SortedValues, float Fraction)
+	{
+		if (SortedValues.Num() == 0)
+		{
+			return 0.f;
+		}
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt(Fraction * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return SortedValues[Rank];
+	}
+
+	static FString FormatPercentiles(const TArray<float>& SortedValues)
+	{
+		return FString::Printf(TEXT("{ \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }"),
+			GetPercentile(SortedValues, 0.5f), GetPercentile(SortedValues, 0.95f), GetPercentile(SortedValues, 0.99f), GetPercentile(SortedValues, 1.f));
+	}
+}
+
+ASPSwingBenchmarkGameMode::ASPSwingBenchmarkGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	DefaultPawnClass = nullptr;
+	bStartPlayersAsSpectators = true;
+
+	CharacterClass = ASwingProjCharacter::StaticClass();
+	AnchorClass = ARopeSwingAttachmentActor::StaticClass();
+	BenchmarkAIControllerClass = ASPSwingBenchmarkAIController::StaticClass();
+}
+
+void ASPSwingBenchmarkGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	const FString ScenarioName = UGameplayStatics::ParseOption(Options, TEXT("Scenario"));
+	if (!ScenarioName.IsEmpty())
+	{
+		const int64 ScenarioValue = StaticEnum<ESPSwingBenchmarkScenario>()->GetValueByNameString(ScenarioName);
+		if (ScenarioValue != INDEX_NONE)
+		{
+			Scenario = (ESPSwingBenchmarkScenario)ScenarioValue;
+		}
+		else
+		{
+			UE_LOG(LogSwingBenchmark, Warning, TEXT("Unknown swing benchmark scenario %s"), *ScenarioName);
+		}
+	}
+	ApplyScenarioDefaults();
+
+	NumCharacters = FMath::Max(1, UGameplayStatics::GetIntOption(Options, TEXT("Characters"), NumCharacters));
+	WarmupTime = FMath::Max(0, UGameplayStatics::GetIntOption(Options, TEXT("Warmup"), FMath::RoundToInt(WarmupTime)));
+	MeasureTime = FMath::Max(1, UGameplayStatics::GetIntOption(Options, TEXT("Duration"), FMath::RoundToInt(MeasureTime)));
+	bCaptureCsvProfile = UGameplayStatics::GetIntOption(Options, TEXT("Csv"), bCaptureCsvProfile ? 1 : 0) != 0;
+
+	if (Scenario != ESPSwingBenchmarkScenario::Free && !FSPCountingMalloc::IsInstalled())
+	{
+		UE_LOG(LogSwingBenchmark, Warning, TEXT("Swing allocations are not counted without -SwingCountAllocations, the allocation check is skipped"));
+	}
+}
+
+void ASPSwingBenchmarkGameMode::ApplyScenarioDefaults()
+{
+	switch (Scenario)
+	{
+		case ESPSwingBenchmarkScenario::SingleSwing:
+		case ESPSwingBenchmarkScenario::ChainedSwings:
+		{
+			NumCharacters = 1;
+			break;
+		}
+		case ESPSwingBenchmarkScenario::ThrowSpam:
+		{
+			NumCharacters = 10;
+			break;
+		}
+		case ESPSwingBenchmarkScenario::ManyCharacters:
+		{
+			NumCharacters = 200;
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+}
+
+void ASPSwingBenchmarkGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	SpawnArena();
+	SpawnCharacters();
+
+	// Enough room for the whole run at 120 fps, the samples are only formatted once the run is over
+	Samples.Reserve(FMath::CeilToInt(MeasureTime * 120.f));
+	LastFrameTime = FPlatformTime::Seconds();
+	USPBaseCharacterMovementComponent::SwingUpdateTiming = FSPSwingUpdateTiming();
+
+	UE_LOG(LogSwingBenchmark, Log, TEXT("Swing benchmark started: scenario %s, %d characters, %.0f s warmup, %.0f s measured"),
+		*StaticEnum<ESPSwingBenchmarkScenario>()->GetNameStringByValue((int64)Scenario), NumCharacters, WarmupTime, MeasureTime);
+}
+
+void ASPSwingBenchmarkGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	const float FrameMs = (float)((CurrentTime - LastFrameTime) * 1000.0);
+	LastFrameTime = CurrentTime;
+
+	const FSPSwingUpdateTiming SwingUpdateTiming = USPBaseCharacterMovementComponent::SwingUpdateTiming;
+	USPBaseCharacterMovementComponent::SwingUpdateTiming = FSPSwingUpdateTiming();
+
+	if (bIsFinished)
+	{
+		return;
+	}
+
+	ElapsedTime += DeltaSeconds;
+	if (ElapsedTime < WarmupTime)
+	{
+		return;
+	}
+
+	SetCsvProfileCaptureActive(bCaptureCsvProfile);
+
+	FFrameSample& Sample = Samples.AddDefaulted_GetRef();
+	Sample.FrameMs = FrameMs;
+	Sample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Sample.SwingUpdateMs = FPlatformTime::ToMilliseconds64(SwingUpdateTiming.Cycles);
+	Sample.NumSwingUpdates = SwingUpdateTiming.NumUpdates;
+	Sample.NumSwingAllocations = (int32)SwingUpdateTiming.NumAllocations;
+	for (const TWeakObjectPtr<ASwingProjCharacter>& SwingCharacter : Characters)
+	{
+		if (SwingCharacter.IsValid() && SwingCharacter->IsSwinging())
+		{
+			Sample.NumSwinging++;
+		}
+	}
+
+	if (ElapsedTime >= WarmupTime + MeasureTime)
+	{
+		FinishBenchmark();
+	}
+}
+
+void ASPSwingBenchmarkGameMode::SpawnArena()
+{
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumCharacters));
+	const float ArenaSize = GridSize * CellSpacing;
+
+	UStaticMesh* FloorMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	AStaticMeshActor* Floor = GetWorld()->SpawnActor<AStaticMeshActor>(ArenaOrigin + FVector(ArenaSize * 0.5f, ArenaSize * 0.5f, -50.f), FRotator::ZeroRotator);
+	if (IsValid(Floor) && IsValid(FloorMesh))
+	{
+		Floor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+		Floor->GetStaticMeshComponent()->SetStaticMesh(FloorMesh);
+		Floor->SetActorScale3D(FVector((ArenaSize + CellSpacing) / 100.f, (ArenaSize + CellSpacing) / 100.f, 1.f));
+	}
+
+	for (int32 i = 0; i < GridSize * GridSize; ++i)
+	{
+		const FVector AnchorLocation = ArenaOrigin + FVector((i % GridSize + 0.5f) * CellSpacing, (i / GridSize + 0.5f) * CellSpacing, AnchorHeight);
+		ARopeSwingAttachmentActor* Anchor = GetWorld()->SpawnActorDeferred<ARopeSwingAttachmentActor>(AnchorClass, FTransform(AnchorLocation));
+		if (IsValid(Anchor))
+		{
+			Anchor->SetInteractionRadius(AnchorInteractionRadius);
+			Anchor->FinishSpawning(FTransform(AnchorLocation));
+		}
+	}
+}
+
+void ASPSwingBenchmarkGameMode::SpawnCharacters()
+{
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumCharacters));
+	const uint64 UsedMemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	Characters.Reserve(NumCharacters);
+	for (int32 i = 0; i < NumCharacters; ++i)
+	{
+		const FVector SpawnLocation = ArenaOrigin + FVector((i % GridSize + 0.2f) * CellSpacing, (i / GridSize + 0.5f) * CellSpacing, 150.f);
+		ASwingProjCharacter* SwingCharacter = GetWorld()->SpawnActor<ASwingProjCharacter>(CharacterClass, SpawnLocation, FRotator::ZeroRotator, SpawnParameters);
+		if (!IsValid(SwingCharacter))
+		{
+			continue;
+		}
+
+		ASPSwingBenchmarkAIController* Controller = GetWorld()->SpawnActor<ASPSwingBenchmarkAIController>(BenchmarkAIControllerClass, SpawnLocation, FRotator::ZeroRotator);
+		if (IsValid(Controller))
+		{
+			Controller->SetRandomSeed(i);
+			if (Scenario == ESPSwingBenchmarkScenario::ChainedSwings)
+			{
+				Controller->SetCycleTimes(0.05f, 0.15f, 0.6f, 1.2f, true);
+			}
+			else if (Scenario == ESPSwingBenchmarkScenario::ThrowSpam)
+			{
+				Controller->SetCycleTimes(0.f, 0.05f, 0.05f, 0.2f, true);
+			}
+			Controller->Possess(SwingCharacter);
+		}
+		Characters.Add(SwingCharacter);
+	}
+
+	const uint64 UsedMemoryAfter = FPlatformMemory::GetStats().UsedPhysical;
+	MemoryPerCharacter = Characters.Num() > 0 ? ((int64)UsedMemoryAfter - (int64)UsedMemoryBefore) / Characters.Num() : 0;
+}
+
+void ASPSwingBenchmarkGameMode::SetCsvProfileCaptureActive(bool bActive)
+{
+#if CSV_PROFILER
+	if (bActive == bIsCapturingCsvProfile)
+	{
+		return;
+	}
+
+	bIsCapturingCsvProfile = bActive;
+	if (bActive)
+	{
+		FCsvProfiler::Get()->BeginCapture();
+	}
+	else
+	{
+		FCsvProfiler::Get()->EndCapture();
+	}
+#endif
+}
+
+void ASPSwingBenchmarkGameMode::FinishBenchmark()
+{
+	bIsFinished = true;
+	SetCsvProfileCaptureActive(false);
+
+	float TotalGameThreadMs = 0.f;
+	float TotalSwingUpdateMs = 0.f;
+	int64 TotalSwingUpdates = 0;
+
+	FString Csv;
+	Csv.Reserve(128 * (Samples.Num() + 8));
+	Csv += FString::Printf(TEXT("# Characters,%d\n# MemoryPerCharacterKB,%.1f\n"), Characters.Num(), MemoryPerCharacter / 1024.f);
+	Csv += TEXT("Frame,FrameMs,GameThreadMs,SwingUpdateMs,SwingUpdates,Swinging,SwingUsPerCharacter,SwingAllocations\n");
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		const FFrameSample& Sample = Samples[i];
+		const float SwingUsPerCharacter = Sample.NumSwingUpdates > 0 ? Sample.SwingUpdateMs * 1000.f / Sample.NumSwingUpdates : 0.f;
+		Csv += FString::Printf(TEXT("%d,%.3f,%.3f,%.4f,%d,%d,%.3f,%d\n"), i, Sample.FrameMs, Sample.GameThreadMs, Sample.SwingUpdateMs, Sample.NumSwingUpdates, Sample.NumSwinging, SwingUsPerCharacter, Sample.NumSwingAllocations);
+
+		TotalGameThreadMs += Sample.GameThreadMs;
+		TotalSwingUpdateMs += Sample.SwingUpdateMs;
+		TotalSwingUpdates += Sample.NumSwingUpdates;
+	}
+
+	const float AverageGameThreadMs = Samples.Num() > 0 ? TotalGameThreadMs / Samples.Num() : 0.f;
+	const float AverageSwingUs = TotalSwingUpdates > 0 ? TotalSwingUpdateMs * 1000.f / TotalSwingUpdates : 0.f;
+
+	const FString FileName = FString::Printf(TEXT("SwingBenchmark_%d_%s.csv"), Characters.Num(), *FDateTime::Now().ToString());
+	const FString FilePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), FileName);
+	FFileHelper::SaveStringToFile(Csv, *FilePath);
+
+	UE_LOG(LogSwingBenchmark, Display, TEXT("Swing benchmark finished: %d characters, %d frames, game thread %.3f ms/frame, swing update %.3f us/character, %.1f KB/character. Written to %s"),
+		Characters.Num(), Samples.Num(), AverageGameThreadMs, AverageSwingUs, MemoryPerCharacter / 1024.f, *FilePath);
+
+	bool bHasPassed = true;
+	if (Scenario != ESPSwingBenchmarkScenario::Free)
+	{
+		const FString ReportName = FString::Printf(TEXT("SwingRegression_%s.json"), *StaticEnum<ESPSwingBenchmarkScenario>()->GetNameStringByValue((int64)Scenario));
+		bHasPassed = CheckRegression(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), TEXT("Regression"), ReportName));
+	}
+
+	if (!GIsEditor)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bHasPassed ? 0 : 1);
+	}
+}
+
+bool ASPSwingBenchmarkGameMode::CheckRegression(const FString& ReportPath) const
+{
+	TArray<float> SwingMs;
+	TArray<float> FrameMs;
+	TArray<float> GameThreadMs;
+	SwingMs.Reserve(Samples.Num());
+	FrameMs.Reserve(Samples.Num());
+	GameThreadMs.Reserve(Samples.Num());
+
+	int64 TotalAllocations = 0;
+	int32 MaxAllocations = 0;
+	for (const FFrameSample& Sample : Samples)
+	{
+		SwingMs.Add(Sample.SwingUpdateMs);
+		FrameMs.Add(Sample.FrameMs);
+		GameThreadMs.Add(Sample.GameThreadMs);
+		TotalAllocations += Sample.NumSwingAllocations;
+		MaxAllocations = FMath::Max(MaxAllocations, Sample.NumSwingAllocations);
+	}
+	SwingMs.Sort();
+	FrameMs.Sort();
+	GameThreadMs.Sort();
+
+	const FString ScenarioName = StaticEnum<ESPSwingBenchmarkScenario>()->GetNameStringByValue((int64)Scenario);
+	const float SwingP95Ms = SPSwingBenchmark::GetPercentile(SwingMs, 0.95f);
+	const float AllocationsPerFrame = Samples.Num() > 0 ? (float)TotalAllocations / Samples.Num() : 0.f;
+
+	TArray<FString> Failures;
+	const FSPSwingRegressionBaseline* Baseline = RegressionBaselines.FindByPredicate([this](const FSPSwingRegressionBaseline& Entry) { return Entry.Scenario == Scenario; });
+	if (Baseline == nullptr)
+	{
+		Failures.Add(FString::Printf(TEXT("No baseline for scenario %s"), *ScenarioName));
+	}
+	else
+	{
+		const float MaxSwingP95Ms = Baseline->SwingP95Ms * (1.f + RegressionTolerance);
+		if (SwingP95Ms > MaxSwingP95Ms)
+		{
+			Failures.Add(FString::Printf(TEXT("Swing p95 %.4f ms exceeds %.4f ms"), SwingP95Ms, MaxSwingP95Ms));
+		}
+
+		const float MaxAllocationsPerFrame = Baseline->AllocationsPerFrame * (1.f + RegressionTolerance) + AllocationSlackPerFrame;
+		if (FSPCountingMalloc::IsInstalled() && AllocationsPerFrame > MaxAllocationsPerFrame)
+		{
+			Failures.Add(FString::Printf(TEXT("%.2f swing allocations per frame exceed %.2f"), AllocationsPerFrame, MaxAllocationsPerFrame));
+		}
+	}
+
+	FString Report = TEXT("{\n");
+	Report += FString::Printf(TEXT("\t\"scenario\": \"%s\",\n\t\"characters\": %d,\n\t\"frames\": %d,\n"), *ScenarioName, Characters.Num(), Samples.Num());
+	Report += FString::Printf(TEXT("\t\"swingMs\": %s,\n"), *SPSwingBenchmark::FormatPercentiles(SwingMs));
+	Report += FString::Printf(TEXT("\t\"frameMs\": %s,\n"), *SPSwingBenchmark::FormatPercentiles(FrameMs));
+	Report += FString::Printf(TEXT("\t\"gameThreadMs\": %s,\n"), *SPSwingBenchmark::FormatPercentiles(GameThreadMs));
+	Report += FString::Printf(TEXT("\t\"allocationsCounted\": %s,\n"), FSPCountingMalloc::IsInstalled() ? TEXT("true") : TEXT("false"));
+	Report += FString::Printf(TEXT("\t\"swingAllocationsPerFrame\": %.3f,\n\t\"maxSwingAllocationsPerFrame\": %d,\n"), AllocationsPerFrame, MaxAllocations);
+	if (Baseline != nullptr)
+	{
+		Report += FString::Printf(TEXT("\t\"baseline\": { \"swingP95Ms\": %.4f, \"allocationsPerFrame\": %.3f, \"tolerance\": %.3f },\n"), Baseline->SwingP95Ms, Baseline->AllocationsPerFrame, RegressionTolerance);
+	}
+	Report += FString::Printf(TEXT("\t\"passed\": %s,\n\t\"failures\": ["), Failures.Num() == 0 ? TEXT("true") : TEXT("false"));
+	for (int32 i = 0; i < Failures.Num(); ++i)
+	{
+		Report += FString::Printf(TEXT("%s\"%s\""), i > 0 ? TEXT(", ") : TEXT(""), *Failures[i]);
+	}
+	Report += TEXT("]\n}\n");
+	FFileHelper::SaveStringToFile(Report, *ReportPath);
+
+	// Ready to paste into DefaultGame.ini when the baseline is meant to move
+	UE_LOG(LogSwingBenchmark, Display, TEXT("Measured: +RegressionBaselines=(Scenario=%s,SwingP95Ms=%.4f,AllocationsPerFrame=%.2f)"), *ScenarioName, SwingP95Ms, AllocationsPerFrame);
+	for (const FString& Failure : Failures)
+	{
+		UE_LOG(LogSwingBenchmark, Error, TEXT("Swing regression in %s: %s"), *ScenarioName, *Failure);
+	}
+	UE_LOG(LogSwingBenchmark, Display, TEXT("Swing regression %s: %s, report written to %s"), *ScenarioName, Failures.Num() == 0 ? TEXT("passed") : TEXT("FAILED"), *ReportPath);
+	return Failures.Num() == 0;
+}
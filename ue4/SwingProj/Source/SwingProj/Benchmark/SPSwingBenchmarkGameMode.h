@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "SPSwingBenchmarkGameMode.generated.h"
+
+class ASwingProjCharacter;
+class ARopeSwingAttachmentActor;
+class ASPSwingBenchmarkAIController;
+
+UENUM()
+enum class ESPSwingBenchmarkScenario : uint8
+{
+	// Plain benchmark, no regression check
+	Free,
+	SingleSwing,
+	ChainedSwings,
+	ThrowSpam,
+	ManyCharacters
+};
+
+USTRUCT()
+struct FSPSwingRegressionBaseline
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	ESPSwingBenchmarkScenario Scenario = ESPSwingBenchmarkScenario::Free;
+
+	// 95th percentile of the summed PhysSwinging time of one frame
+	UPROPERTY()
+	float SwingP95Ms = 0.f;
+
+	// Game thread allocations made inside PhysSwinging per frame
+	UPROPERTY()
+	float AllocationsPerFrame = 0.f;
+};
+
+/**
+ * Spawns an arena of rope anchors with AI driven swinging characters and writes per frame timings to Saved/Benchmarks.
+ * Runs headless, e.g. SwingProj ThirdPersonExampleMap?game=SwingBenchmark?Characters=100 -game -nullrhi -nosound -unattended
+ * With Scenario= the run is checked against RegressionBaselines, a report goes to Saved/Benchmarks/Regression and a regression exits with code 1.
+ */
+UCLASS(config = Game)
+class SWINGPROJ_API ASPSwingBenchmarkGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	ASPSwingBenchmarkGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void StartPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	TSubclassOf<ASwingProjCharacter> CharacterClass;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	TSubclassOf<ARopeSwingAttachmentActor> AnchorClass;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	TSubclassOf<ASPSwingBenchmarkAIController> BenchmarkAIControllerClass;
+
+	// Overridden by the Characters= URL option
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark, meta = (ClampMin = "1", UIMin = "1"))
+	int32 NumCharacters = 10;
+
+	// Overridden by the Warmup= URL option
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark, meta = (ClampMin = "0", UIMin = "0"))
+	float WarmupTime = 5.f;
+
+	// Overridden by the Duration= URL option
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark, meta = (ClampMin = "1", UIMin = "1"))
+	float MeasureTime = 30.f;
+
+	// Overridden by the Scenario= URL option
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	ESPSwingBenchmarkScenario Scenario = ESPSwingBenchmarkScenario::Free;
+
+	UPROPERTY(Config)
+	TArray<FSPSwingRegressionBaseline> RegressionBaselines;
+
+	// Fraction a measurement may exceed its baseline by before the run fails
+	UPROPERTY(Config)
+	float RegressionTolerance = 0.25f;
+
+	// Allocation counts are small numbers, this many extra per frame are not treated as a regression
+	UPROPERTY(Config)
+	float AllocationSlackPerFrame = 2.f;
+
+	// Captures the measured frames with the CSV profiler too, overridden by the Csv= URL option
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	bool bCaptureCsvProfile = false;
+
+	// The arena is spawned away from the level content so it works on any map
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	FVector ArenaOrigin = FVector(0.f, 0.f, 20000.f);
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float CellSpacing = 600.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float AnchorHeight = 500.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = Benchmark)
+	float AnchorInteractionRadius = 700.f;
+
+private:
+	struct FFrameSample
+	{
+		float FrameMs = 0.f;
+		float GameThreadMs = 0.f;
+		float SwingUpdateMs = 0.f;
+		int32 NumSwingUpdates = 0;
+		int32 NumSwinging = 0;
+		int32 NumSwingAllocations = 0;
+	};
+
+	void SpawnArena();
+	void SpawnCharacters();
+	void FinishBenchmark();
+	void SetCsvProfileCaptureActive(bool bActive);
+	void ApplyScenarioDefaults();
+	// Returns false on a regression
+	bool CheckRegression(const FString& ReportPath) const;
+
+	TArray<TWeakObjectPtr<ASwingProjCharacter>> Characters;
+	TArray<FFrameSample> Samples;
+
+	double LastFrameTime = 0.0;
+	float ElapsedTime = 0.f;
+	int64 MemoryPerCharacter = 0;
+	bool bIsFinished = false;
+	bool bIsCapturingCsvProfile = false;
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Simulation/SPSwingKernel.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSwingKernelBenchmark, Log, All);
+
+namespace SPSwingKernelBenchmark
+{
+	static constexpr float FrameTime = 1.f / 60.f;
+
+	void Run(const TArray<FString>& Args)
+	{
+		const int32 NumStates = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+		const int32 NumFrames = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1000;
+
+		FRandomStream RandomStream(0);
+		TArray<FSPSwingState> States;
+		States.SetNum(NumStates);
+		for (FSPSwingState& State : States)
+		{
+			State.AnchorLocation = RandomStream.VRand() * 10000.f;
+			State.RopeLength = RandomStream.FRandRange(200.f, 1500.f);
+			State.Location = State.AnchorLocation + RandomStream.VRand() * State.RopeLength;
+			State.Velocity = RandomStream.VRand() * RandomStream.FRandRange(0.f, 1500.f);
+			State.Acceleration = FVector(0.f, 0.f, -980.f);
+			State.ImpulseRatio = 1.5f;
+		}
+
+		const FSPSwingStepParams Params;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FSPSwingKernel::StepStates(States, FrameTime, Params);
+		}
+		const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+		// Every swinger has to end up inside its rope sphere with a finite state
+		int32 NumInvalid = 0;
+		for (const FSPSwingState& State : States)
+		{
+			const bool bIsValid = !State.Location.ContainsNaN() && !State.Velocity.ContainsNaN()
+				&& FVector::Dist(State.Location, State.AnchorLocation) <= State.RopeLength + KINDA_SMALL_NUMBER * State.RopeLength + 0.1f
+				&& State.Velocity.Size() <= Params.MaxSpeed + 1.f;
+			NumInvalid += bIsValid ? 0 : 1;
+		}
+
+		const int64 NumSteps = (int64)NumStates * NumFrames;
+		UE_LOG(LogSwingKernelBenchmark, Display, TEXT("Swing kernel: %lld frame steps in %.2f ms, %.1f ns/step, %d invalid states"),
+			NumSteps, ElapsedTime * 1000.0, ElapsedTime * 1e9 / NumSteps, NumInvalid);
+	}
+}
+
+static FAutoConsoleCommand SwingKernelBenchmarkCommand(
+	TEXT("Swing.KernelBenchmark"),
+	TEXT("Steps [NumStates=1000] swing states for [NumFrames=1000] frames with the swing kernel and checks the results"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SPSwingKernelBenchmark::Run));
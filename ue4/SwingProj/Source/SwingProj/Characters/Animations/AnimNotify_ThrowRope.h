@@ -7,12 +7,11 @@
 #include "AnimNotify_ThrowRope.generated.h"
 
 /**
- * 
+ * Marks the release frame of throw montages. The rope is thrown by ASwingProjCharacter::ThrowRope as a hook projectile
+ * and attaches on contact, so the notify no longer drives the attach.
  */
 UCLASS()
 class SWINGPROJ_API UAnimNotify_ThrowRope : public UAnimNotify
 {
 	GENERATED_BODY()
-
-	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
 };
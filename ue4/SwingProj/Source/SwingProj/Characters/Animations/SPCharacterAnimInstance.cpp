@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPCharacterAnimInstance.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Characters/SwingProjCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "SwingProj.h"
+
+DECLARE_CYCLE_STAT(TEXT("Anim Proxy Update"), STAT_SwingAnimProxyUpdate, STATGROUP_Swing);
+
+void FSPCharacterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	HangInterpSpeed = CastChecked<USPCharacterAnimInstance>(InAnimInstance)->HangInterpSpeed;
+
+	const ASwingProjCharacter* Character = Cast<ASwingProjCharacter>(InAnimInstance->TryGetPawnOwner());
+	if (!IsValid(Character))
+	{
+		bIsSwinging = false;
+		bIsInAir = false;
+		Velocity = FVector::ZeroVector;
+		return;
+	}
+
+	bIsSwinging = Character->IsSwinging();
+	bIsInAir = Character->GetCharacterMovement()->IsFalling();
+	RopeVector = Character->GetCurrentRopeVector();
+	ActorRotation = Character->GetActorRotation();
+	Velocity = Character->GetVelocity();
+}
+
+void FSPCharacterAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	SCOPE_SWING_STAT(AnimProxyUpdate);
+	Super::Update(DeltaSeconds);
+
+	Speed = Velocity.Size();
+
+	float TargetPitch = 0.f;
+	float TargetYaw = 0.f;
+	SwingSpeed = 0.f;
+	if (bIsSwinging && !RopeVector.IsNearlyZero())
+	{
+		const FRotator RopeRotation = (RopeVector.ToOrientationRotator() - ActorRotation).GetNormalized();
+		TargetPitch = RopeRotation.Pitch;
+		TargetYaw = RopeRotation.Yaw;
+
+		const FVector RopeDirection = RopeVector.GetUnsafeNormal();
+		SwingSpeed = (Velocity - RopeDirection * (Velocity | RopeDirection)).Size();
+	}
+
+	// Yaw is interpolated along the shorter arc
+	HangPitch = FMath::FInterpTo(HangPitch, TargetPitch, DeltaSeconds, HangInterpSpeed);
+	HangYaw = FRotator::NormalizeAxis(FMath::FInterpTo(HangYaw, HangYaw + FMath::FindDeltaAngleDegrees(HangYaw, TargetYaw), DeltaSeconds, HangInterpSpeed));
+}
+
+bool USPCharacterAnimInstance::ShouldSkipThrowMontage() const
+{
+	const USkeletalMeshComponent* MeshComponent = GetSkelMeshComponent();
+	const UWorld* World = GetWorld();
+	if (!bEnableFastPath || !IsValid(MeshComponent) || !IsValid(World) || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	const FVector Location = MeshComponent->GetComponentLocation();
+	bool bHasLocalCamera = false;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!IsValid(PlayerController) || !PlayerController->IsLocalController() || !IsValid(PlayerController->PlayerCameraManager))
+		{
+			continue;
+		}
+
+		bHasLocalCamera = true;
+		if (FVector::DistSquared(PlayerController->PlayerCameraManager->GetCameraLocation(), Location) <= FMath::Square(FastPathDistance))
+		{
+			return false;
+		}
+	}
+	return bHasLocalCamera;
+}
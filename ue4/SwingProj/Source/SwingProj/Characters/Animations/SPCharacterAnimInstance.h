@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "SPCharacterAnimInstance.generated.h"
+
+/**
+ * Swing state is copied from the character on the game thread, the hang blend parameters are computed during the parallel anim update
+ */
+USTRUCT(BlueprintType)
+struct SWINGPROJ_API FSPCharacterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FSPCharacterAnimInstanceProxy()
+		: FAnimInstanceProxy()
+	{
+	}
+
+	FSPCharacterAnimInstanceProxy(UAnimInstance* InAnimInstance)
+		: FAnimInstanceProxy(InAnimInstance)
+	{
+	}
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Swing)
+	bool bIsSwinging = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Swing)
+	bool bIsInAir = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Swing)
+	float Speed = 0.f;
+
+	// Rope direction relative to the actor, same as ASwingProjCharacter::GetCurrentRopeRotation but smoothed
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Swing)
+	float HangPitch = 0.f;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Swing)
+	float HangYaw = 0.f;
+
+	// Speed across the rope, drives the hang blendspace
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Swing)
+	float SwingSpeed = 0.f;
+
+protected:
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	FVector RopeVector = FVector::ZeroVector;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	FVector Velocity = FVector::ZeroVector;
+	float HangInterpSpeed = 0.f;
+};
+
+template<>
+struct TStructOpsTypeTraits<FSPCharacterAnimInstanceProxy> : public TStructOpsTypeTraitsBase2<FSPCharacterAnimInstanceProxy>
+{
+	enum
+	{
+		// The proxy belongs to one anim instance
+		WithCopy = false
+	};
+};
+
+/**
+ * Native parent for the character anim blueprint, the graph reads the Proxy members instead of calling the character's Blueprint getters
+ */
+UCLASS(Transient, Blueprintable)
+class SWINGPROJ_API USPCharacterAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+	friend struct FSPCharacterAnimInstanceProxy;
+
+public:
+	// True when the character is too far from every local camera for the throw montage to be seen
+	bool ShouldSkipThrowMontage() const;
+
+protected:
+	// 0 snaps the hang pose to the rope
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Swing, meta = (ClampMin = "0", UIMin = "0"))
+	float HangInterpSpeed = 10.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Swing|Fast Path")
+	bool bEnableFastPath = true;
+
+	// Characters farther than this from every local camera skip the throw montage. Without local cameras, as on a dedicated server, it always plays
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Swing|Fast Path", meta = (ClampMin = "0", UIMin = "0"))
+	float FastPathDistance = 3000.f;
+
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override { return &Proxy; }
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override {}
+
+private:
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Swing, meta = (AllowPrivateAccess = "true"))
+	FSPCharacterAnimInstanceProxy Proxy;
+};
@@ -6,13 +6,28 @@
 #include "Actors/Interactive/RopeSwingAttachmentActor.h"
 #include "Camera/CameraComponent.h"
 #include "Chaos/ChaosDebugDraw.h"
+#include "Characters/Animations/SPCharacterAnimInstance.h"
+#include "Components/CameraComponents/SPSwingSpringArmComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
+#include "Components/InteractionComponents/SPAnchorVisibilityComponent.h"
 #include "Components/MovementComponents/SPBaseCharacterMovementComponent.h"
+#include "Components/MovementComponents/SPSwingReleasePredictorComponent.h"
+#include "Components/RopeComponents/SPRopeComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
-#include "CableComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Recording/SPSwingRecorderComponent.h"
+#include "Subsystems/SPHookProjectileSubsystem.h"
+#include "Subsystems/SPRopeAnchorSubsystem.h"
+#include "Subsystems/SPSwingManagerSubsystem.h"
+#include "SwingProj.h"
+#include "Telemetry/SPSwingTelemetry.h"
+
+DECLARE_CYCLE_STAT(TEXT("Throw Rope"), STAT_SwingThrowRope, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Rope Attached"), STAT_SwingRopeAttached, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Dettach From Rope"), STAT_SwingDettachFromRope, STATGROUP_Swing);
 
 //////////////////////////////////////////////////////////////////////////
 // ASwingProjCharacter
@@ -20,6 +35,9 @@
 ASwingProjCharacter::ASwingProjCharacter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass<USPBaseCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
+	// Swinging characters are updated in one pass by USPSwingManagerSubsystem, the actor itself has nothing to tick
+	PrimaryActorTick.bCanEverTick = false;
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 
@@ -40,7 +58,7 @@ ASwingProjCharacter::ASwingProjCharacter(const FObjectInitializer& ObjectInitial
 	GetCharacterMovement()->AirControl = 0.2f;
 
 	// Create a camera boom (pulls in towards the player if there is a collision)
-	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
+	CameraBoom = CreateDefaultSubobject<USPSwingSpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
 	CameraBoom->TargetArmLength = 300.0f; // The camera follows at this distance behind the character	
 	CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
@@ -53,28 +71,45 @@ ASwingProjCharacter::ASwingProjCharacter(const FObjectInitializer& ObjectInitial
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named MyCharacter (to avoid direct content references in C++)
 
-	HookMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Hook"));
-	HookMesh->SetupAttachment(GetMesh());
-	HookMesh->SetMobility(EComponentMobility::Movable);
-	
-	Rope = CreateDefaultSubobject<UCableComponent>(TEXT("Rope"));
-	Rope->SetupAttachment(GetMesh());
-	HookMesh->SetMobility(EComponentMobility::Movable);
+	BeltRopeMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("BeltRope"));
+	BeltRopeMesh->SetupAttachment(GetMesh(), FName(TEXT("BeltSocket")));
+	BeltRopeMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	BeltRopeMesh->SetGenerateOverlapEvents(false);
+
+	SwingReleasePredictor = CreateDefaultSubobject<USPSwingReleasePredictorComponent>(TEXT("SwingReleasePredictor"));
+	SwingRecorder = CreateDefaultSubobject<USPSwingRecorderComponent>(TEXT("SwingRecorder"));
+	AnchorVisibility = CreateDefaultSubobject<USPAnchorVisibilityComponent>(TEXT("AnchorVisibility"));
 }
 
-void ASwingProjCharacter::OnConstruction(const FTransform& Transform)
+void ASwingProjCharacter::BeginPlay()
 {
-	Super::OnConstruction(Transform);
+	Super::BeginPlay();
+	StableId = FSPSwingRecordFrame::GetAnchorId(this);
+	UpdateLocallyControlledTicks();
+}
 
-	HookMesh->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("HandGrabSocket")));
-	
-	Rope->CableLength = 100.f;
-	Rope->CableWidth = 3.f;
-	Rope->bEnableStiffness = true;
-	Rope->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("BeltSocket"))));
-	Rope->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("BeltSocket")));
-	//Rope->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("HandGrabSocket"))));
-	Rope->SetAttachEndTo(this, FName(TEXT("HookMesh")));
+void ASwingProjCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetAttachedInteractiveActor(nullptr);
+	ReleaseRope();
+	USPSwingManagerSubsystem* SwingManagerSubsystem = GetWorld()->GetSubsystem<USPSwingManagerSubsystem>();
+	if (IsValid(SwingManagerSubsystem))
+	{
+		SwingManagerSubsystem->UnregisterSwinger(this);
+	}
+	USPHookProjectileSubsystem* HookProjectileSubsystem = GetWorld()->GetSubsystem<USPHookProjectileSubsystem>();
+	if (IsValid(HookProjectileSubsystem))
+	{
+		HookProjectileSubsystem->Cancel(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASwingProjCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME_CONDITION(ASwingProjCharacter, ReplicatedSwingState, COND_SimulatedOnly);
+	DOREPLIFETIME(ASwingProjCharacter, ReplicatedRopeWrap);
 }
 
 USPBaseCharacterMovementComponent* ASwingProjCharacter::GetBaseCharacterMovementComponent() const
@@ -84,31 +119,83 @@ USPBaseCharacterMovementComponent* ASwingProjCharacter::GetBaseCharacterMovement
 
 void ASwingProjCharacter::Jump()
 {
+	SwingRecorder->RecordEvent(ESPSwingRecordEvent::Jump);
 	Super::Jump();
-	if (bIsSwinging && GetCharacterMovement()->IsFalling())
+	if (IsSwinging())
 	{
 		DettachFromRope();
 	}
 }
 
-FRotator ASwingProjCharacter::GetCurrentRopeRotation() const
+void ASwingProjCharacter::StopJumping()
 {
-	return CurrentRopeVector.ToOrientationRotator() - GetActorRotation();
+	SwingRecorder->RecordEvent(ESPSwingRecordEvent::StopJumping);
+	Super::StopJumping();
+}
+
+void ASwingProjCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	// Runs for predicted, corrected and replicated mode changes alike, so rope visuals follow the movement mode
+	const bool bWasSwinging = PrevMovementMode == MOVE_Custom && PreviousCustomMode == (uint8)ECustomMovementMode::CMOVE_Swinging;
+	if (!bWasSwinging && IsSwinging())
+	{
+		OnRopeAttached();
+	}
+	else if (bWasSwinging && !IsSwinging())
+	{
+		OnRopeDetached();
+	}
+}
+
+void ASwingProjCharacter::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+	UpdateLocallyControlledTicks();
 }
 
-void ASwingProjCharacter::RegisterInteractiveActor(AInteractiveActor* InteractiveActor)
+void ASwingProjCharacter::UnPossessed()
 {
-	AvailableInteractiveActors.AddUnique(InteractiveActor);
+	Super::UnPossessed();
+	UpdateLocallyControlledTicks();
 }
 
-void ASwingProjCharacter::UnRegisterInteractiveActor(AInteractiveActor* InteractiveActor)
+void ASwingProjCharacter::OnRep_Controller()
 {
-	AvailableInteractiveActors.RemoveSingleSwap(InteractiveActor);
+	Super::OnRep_Controller();
+	UpdateLocallyControlledTicks();
 }
 
-TArray<AInteractiveActor*> ASwingProjCharacter::GetCurrentAvailableInteractiveActors() const
+bool ASwingProjCharacter::IsSwinging() const
 {
-	return AvailableInteractiveActors;
+	return BaseCharacterMovementComponent->IsSwinging();
+}
+
+bool ASwingProjCharacter::IsDrivenBySwingRecording() const
+{
+	return SwingRecorder->IsPlayingBack();
+}
+
+FRotator ASwingProjCharacter::GetCurrentRopeRotation() const
+{
+	return CurrentRopeVector.ToOrientationRotator() - GetActorRotation();
+}
+
+TArrayView<AInteractiveActor* const> ASwingProjCharacter::GetCurrentAvailableInteractiveActors() const
+{
+	return AvailableInteractiveActors.GetActors();
+}
+
+void ASwingProjCharacter::UpdateAvailableInteractiveActors()
+{
+	AvailableInteractiveActors.Reset();
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (IsValid(RopeAnchorSubsystem))
+	{
+		RopeAnchorSubsystem->GatherAvailableInteractiveActors(GetActorLocation(), AvailableInteractiveActors);
+		AnchorVisibility->ApplyToCandidates(AvailableInteractiveActors);
+	}
 }
 
 ARopeSwingAttachmentActor* ASwingProjCharacter::GetCurrentRopeSwingAttachActor() const
@@ -139,75 +226,177 @@ void ASwingProjCharacter::SetupPlayerInputComponent(class UInputComponent* Playe
 	PlayerInputComponent->BindAxis("LookUpRate", this, &ASwingProjCharacter::LookUpAtRate);
 }
 
+bool ASwingProjCharacter::LeaseRope()
+{
+	FSPSwingAllocationScope AllocationScope;
+	if (RopeLease.IsValid())
+	{
+		return true;
+	}
+
+	// Nobody sees the rope on a dedicated server
+	USPRopePoolSubsystem* RopePoolSubsystem = GetWorld()->GetSubsystem<USPRopePoolSubsystem>();
+	if (GetNetMode() == NM_DedicatedServer || !IsValid(RopePoolSubsystem))
+	{
+		return false;
+	}
+
+	RopeLease = RopePoolSubsystem->Lease(HookStaticMesh, RopeMaterial, RopeWidth);
+	if (RopeLease.IsValid())
+	{
+		BeltRopeMesh->SetVisibility(false);
+	}
+	return RopeLease.IsValid();
+}
+
+void ASwingProjCharacter::ReleaseRope()
+{
+	FSPSwingAllocationScope AllocationScope;
+	if (!RopeLease.IsValid())
+	{
+		return;
+	}
+
+	USPRopePoolSubsystem* RopePoolSubsystem = GetWorld()->GetSubsystem<USPRopePoolSubsystem>();
+	if (IsValid(RopePoolSubsystem))
+	{
+		RopePoolSubsystem->Release(RopeLease);
+	}
+	RopeLease = FSPRopeLease();
+	BeltRopeMesh->SetVisibility(true);
+}
+
+void ASwingProjCharacter::UpdateRopeWrapVisual()
+{
+	if (!RopeLease.IsValid() || !IsSwinging())
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<8>> WrapLocations;
+	for (const FSPRopeWrapPoint& WrapPoint : BaseCharacterMovementComponent->GetRopeWrapPoints())
+	{
+		WrapLocations.Add(WrapPoint.Location);
+	}
+	RopeLease.Rope->SetWrapPoints(WrapLocations);
+}
+
+void ASwingProjCharacter::UpdateLocallyControlledTicks()
+{
+	const bool bIsLocallyControlled = IsLocallyControlled();
+	AnchorVisibility->SetComponentTickEnabled(bIsLocallyControlled);
+	if (bIsLocallyControlled && IsSwinging())
+	{
+		SwingReleasePredictor->StartPredicting();
+	}
+	else
+	{
+		SwingReleasePredictor->StopPredicting();
+	}
+}
+
 void ASwingProjCharacter::EquipRope()
 {
-	if (IsValid(Rope))
+	// Hook in the hand, rope hanging from the belt
+	if (LeaseRope())
 	{
-		HookMesh->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("HandGrabSocket")));
-		HookMesh->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("HandGrabSocket"))));
-		Rope->CableLength = 100.f;
-		Rope->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("BeltSocket"))));
-		Rope->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("BeltSocket")));
+		RopeLease.Hook->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("HandGrabSocket")));
+		RopeLease.Hook->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("HandGrabSocket"))));
+		RopeLease.Rope->SetRopeLength(100.f);
+		RopeLease.Rope->SetSimulationEnabled(false);
+		RopeLease.Rope->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("BeltSocket"))));
+		RopeLease.Rope->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("BeltSocket")));
 	}
 }
 
 void ASwingProjCharacter::ThrowRope()
 {
-	if (bIsSwinging || IsValid(CurrentRopeSwingAttachActor))
+	SCOPE_SWING_STAT(ThrowRope);
+	FSPSwingAllocationScope AllocationScope;
+	SwingRecorder->RecordEvent(ESPSwingRecordEvent::ThrowRope);
+
+	if (IsSwinging() || IsValid(CurrentRopeSwingAttachActor))
 	{
 		DettachFromRope();
 		return;
 	}
 	
-	CurrentRopeSwingAttachActor = nullptr;
-	float MinCosine = 0.35f;
-	for (uint8 i = 0; i < GetCurrentAvailableInteractiveActors().Num(); ++i)
+	UpdateAvailableInteractiveActors();
+
+	FSPAnchorScoringParams ScoringParams;
+	ScoringParams.Origin = GetActorLocation();
+	ScoringParams.ViewDirection = FollowCamera->GetForwardVector();
+	ScoringParams.MinCosine = ThrowRopeMinCosine;
+	ScoringParams.MaxDistance = ThrowRopeMaxDistance;
+	ScoringParams.DistanceWeight = ThrowRopeDistanceWeight;
+	ScoringParams.HysteresisBonus = ThrowRopeHysteresisBonus;
+	ScoringParams.PreviousActor = LastSelectedInteractiveActor.Get();
+	ScoringParams.RequiredType = EInteractiveActorType::RopeSwingAttachment;
+
+	// Only rope swing attachments pass the type filter
+	float BestScore = 0.f;
+	const int32 BestIndex = AvailableInteractiveActors.FindBestIndex(ScoringParams, &BestScore);
+	CurrentRopeSwingAttachActor = BestIndex != INDEX_NONE ? StaticCast<ARopeSwingAttachmentActor*>(AvailableInteractiveActors.GetActor(BestIndex)) : nullptr;
+	if (FSPSwingTelemetry::IsCapturing() && BestIndex != INDEX_NONE)
 	{
-		AInteractiveActor* CurrentActor = GetCurrentAvailableInteractiveActors()[i];
-		float CurrentCosine = FVector::DotProduct(FollowCamera->GetForwardVector(), (CurrentActor->GetActorLocation() - GetActorLocation()).GetSafeNormal());
-		if (CurrentActor->IsA<ARopeSwingAttachmentActor>() && CurrentCosine > MinCosine)
-		{
-			MinCosine = CurrentCosine; 
-			CurrentRopeSwingAttachActor = StaticCast<ARopeSwingAttachmentActor*>(CurrentActor);
-		}
+		FSPSwingTelemetry::Push(ESPSwingTelemetryEvent::AnchorSelected, StableId, CurrentRopeSwingAttachActor->GetStableId(), BestScore,
+			FVector::Dist(AvailableInteractiveActors.GetLocation(BestIndex), ScoringParams.Origin), (float)AvailableInteractiveActors.Num());
 	}
 
 	if (IsValid(CurrentRopeSwingAttachActor))
 	{
+		LastSelectedInteractiveActor = CurrentRopeSwingAttachActor;
+		BaseCharacterMovementComponent->SaveSwingThrowTimeStamp();
 		CurrentRopeVector = CurrentRopeSwingAttachActor->GetActorLocation() - GetActorLocation();
-		PlayAnimMontage(ThrowMontage);
+		EquipRope();
+
+		// The montage is only cosmetic, the hook leaves the hand right away and attaches on contact
+		const USPCharacterAnimInstance* AnimInstance = Cast<USPCharacterAnimInstance>(GetMesh()->GetAnimInstance());
+		if (!IsValid(AnimInstance) || !AnimInstance->ShouldSkipThrowMontage())
+		{
+			PlayAnimMontage(ThrowMontage);
+		}
+
+		USPHookProjectileSubsystem* HookProjectileSubsystem = GetWorld()->GetSubsystem<USPHookProjectileSubsystem>();
+		const FVector HookStartLocation = GetMesh()->GetSocketLocation(FName(TEXT("HandGrabSocket")));
+		if (!IsValid(HookProjectileSubsystem) || !HookProjectileSubsystem->Launch(this, CurrentRopeSwingAttachActor, HookStartLocation, RopeLease.Hook))
+		{
+			OnHookContact();
+		}
 	}
 }
 
-void ASwingProjCharacter::UpdateRopeSwing(float DeltaTime)
+void ASwingProjCharacter::OnHookContact()
 {
-	if (!bIsSwinging || !IsValid(CurrentRopeSwingAttachActor))
+	FSPSwingAllocationScope AllocationScope;
+	// Replays attach on the recorded frame instead
+	if (!IsDrivenBySwingRecording())
 	{
-		return;
+		AttachToRope();
 	}
+}
 
-	//DrawDebugLine(GetWorld(), GetActorLocation(), GetActorLocation() + CurrentRopeVector, FColor::Green, false, -1, 0, 2);
-	
-	CurrentRopeVector = CurrentRopeSwingAttachActor->GetActorLocation() - GetActorLocation();
-	FVector CurrentRopeVectorNormal = CurrentRopeVector.GetSafeNormal();
-	
-	if ((CurrentRopeVector.Size() > CurrentRopeLength || FMath::IsNearlyEqual(CurrentRopeVector.Size(), CurrentRopeLength, 10.f)) && bIsRopeStretched == false)
+void ASwingProjCharacter::OnHookMissed()
+{
+	FSPSwingAllocationScope AllocationScope;
+	if (!IsDrivenBySwingRecording())
 	{
-		bIsRopeStretched = true;
+		DettachFromRope();
 	}
-		
-	if (bIsRopeStretched)
+}
+
+void ASwingProjCharacter::OnSwingTargetRejected()
+{
+	DettachFromRope();
+}
+
+void ASwingProjCharacter::OnRopeWrapChanged()
+{
+	if (HasAuthority())
 	{
-		FVector RopeImpulse = CurrentRopeVectorNormal * GetVelocity().Size() * GetCharacterMovement()->Mass * RopeImpulseRatio * FVector::DotProduct(CurrentRopeVectorNormal, -GetVelocity().GetSafeNormal());
-		if (FVector::DotProduct(CurrentRopeVectorNormal, FVector::UpVector) < 0.f || FVector::DotProduct(CurrentRopeVectorNormal, GetVelocity().GetSafeNormal()) > 0.f)
-		{
-			bIsRopeStretched = false;
-			return;
-		}
-		
-		GetCharacterMovement()->AddImpulse(RopeImpulse);
-		//DrawDebugLine(GetWorld(), GetActorLocation(), GetActorLocation() + RopeImpulse.GetSafeNormal() * 150.f, FColor::Red, false, -1, 0, 4);
+		BaseCharacterMovementComponent->GetRopeWrapNetState(ReplicatedRopeWrap);
 	}
+	UpdateRopeWrapVisual();
 }
 
 void ASwingProjCharacter::TurnAtRate(float Rate)
@@ -222,12 +411,6 @@ void ASwingProjCharacter::LookUpAtRate(float Rate)
 	AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds());
 }
 
-void ASwingProjCharacter::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-	UpdateRopeSwing(DeltaTime);
-}
-
 void ASwingProjCharacter::MoveForward(float Value)
 {
 	if ((Controller != NULL) && (Value != 0.0f))
@@ -259,35 +442,145 @@ void ASwingProjCharacter::MoveRight(float Value)
 
 void ASwingProjCharacter::AttachToRope()
 {
-	//TODO
-	OnRopeAttached();
+	SwingRecorder->RecordEvent(ESPSwingRecordEvent::AttachToRope);
+
+	if (!IsValid(CurrentRopeSwingAttachActor))
+	{
+		return;
+	}
+
+	const float RopeLength = (CurrentRopeSwingAttachActor->GetActorLocation() - GetActorLocation()).Size();
+	BaseCharacterMovementComponent->RequestSwing(CurrentRopeSwingAttachActor, RopeLength);
 }
 
 void ASwingProjCharacter::OnRopeAttached()
 {
-	CurrentRopeLength = CurrentRopeVector.Size();
-	bIsSwinging = true;
-	bIsRopeStretched = false;
+	SCOPE_SWING_STAT(RopeAttached);
+	FSPSwingAllocationScope AllocationScope;
+	const FSPRopeSwingNetState& SwingTarget = BaseCharacterMovementComponent->GetSwingTarget();
+	CurrentRopeSwingAttachActor = Cast<ARopeSwingAttachmentActor>(SwingTarget.Anchor);
+	if (!IsValid(CurrentRopeSwingAttachActor))
+	{
+		return;
+	}
+
+	if (HasAuthority())
+	{
+		ReplicatedSwingState = SwingTarget;
+	}
+
+	SetAttachedInteractiveActor(CurrentRopeSwingAttachActor);
+	// Nothing reads the prediction on servers and simulated proxies
+	if (IsLocallyControlled())
+	{
+		SwingReleasePredictor->StartPredicting();
+	}
+	CurrentRopeVector = CurrentRopeSwingAttachActor->GetActorLocation() - GetActorLocation();
+	if (FSPSwingTelemetry::IsCapturing())
+	{
+		FSPSwingTelemetry::Push(ESPSwingTelemetryEvent::RopeAttached, StableId, CurrentRopeSwingAttachActor->GetStableId(), BaseCharacterMovementComponent->GetSwingRopeLength());
+	}
+
+	USPSwingManagerSubsystem* SwingManagerSubsystem = GetWorld()->GetSubsystem<USPSwingManagerSubsystem>();
+	if (IsValid(SwingManagerSubsystem))
+	{
+		SwingManagerSubsystem->RegisterSwinger(this);
+	}
 	
-	if (IsValid(Rope) && IsValid(CurrentRopeSwingAttachActor))
+	if (LeaseRope())
 	{
-		HookMesh->AttachToComponent(CurrentRopeSwingAttachActor->GetMesh(), FAttachmentTransformRules::KeepWorldTransform);
-		HookMesh->SetWorldLocation(CurrentRopeSwingAttachActor->GetActorLocation());
-		Rope->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("HandGrabSocket"))));
-		Rope->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("HandGrabSocket")));
-		Rope->CableLength = CurrentRopeLength * 0.7f;
+		RopeLease.Hook->AttachToComponent(CurrentRopeSwingAttachActor->GetMesh(), FAttachmentTransformRules::KeepWorldTransform);
+		RopeLease.Hook->SetWorldLocation(CurrentRopeSwingAttachActor->GetActorLocation());
+		RopeLease.Rope->SetWorldLocation(GetMesh()->GetSocketLocation(FName(TEXT("HandGrabSocket"))));
+		RopeLease.Rope->AttachToComponent(GetMesh(), FAttachmentTransformRules::KeepWorldTransform, FName(TEXT("HandGrabSocket")));
+		RopeLease.Rope->SetRopeLength(BaseCharacterMovementComponent->GetSwingRopeLength() * 0.7f);
+		RopeLease.Rope->SetSimulationEnabled(true);
 	}
+
+	// Simulated proxies may have got the wrap points before they started swinging
+	if (GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		BaseCharacterMovementComponent->SetRopeWrapFromServer(ReplicatedRopeWrap);
+	}
+	UpdateRopeWrapVisual();
 }
 
-void ASwingProjCharacter::DettachFromRope()
+void ASwingProjCharacter::OnRopeDetached()
 {
-	EquipRope();
-	bIsSwinging = false;
-	if (IsValid(CurrentRopeSwingAttachActor))
+	FSPSwingAllocationScope AllocationScope;
+	if (FSPSwingTelemetry::IsCapturing())
+	{
+		FSPSwingTelemetry::Push(ESPSwingTelemetryEvent::RopeDetached, StableId, IsValid(CurrentRopeSwingAttachActor) ? CurrentRopeSwingAttachActor->GetStableId() : 0, GetVelocity().Size());
+	}
+	USPHookProjectileSubsystem* HookProjectileSubsystem = GetWorld()->GetSubsystem<USPHookProjectileSubsystem>();
+	if (IsValid(HookProjectileSubsystem))
+	{
+		HookProjectileSubsystem->Cancel(this);
+	}
+	ReleaseRope();
+	USPSwingManagerSubsystem* SwingManagerSubsystem = GetWorld()->GetSubsystem<USPSwingManagerSubsystem>();
+	if (IsValid(SwingManagerSubsystem))
+	{
+		SwingManagerSubsystem->UnregisterSwinger(this);
+	}
+	SetAttachedInteractiveActor(nullptr);
+	if (IsLocallyControlled())
 	{
-		CurrentRopeSwingAttachActor = nullptr;
+		SwingReleasePredictor->StopPredicting();
 	}
+	CurrentRopeSwingAttachActor = nullptr;
 	CurrentRopeVector = FVector::ZeroVector;
-	CurrentRopeLength = 0.f;
-	bIsRopeStretched = false;
+
+	if (HasAuthority())
+	{
+		ReplicatedSwingState = FSPRopeSwingNetState();
+	}
+}
+
+void ASwingProjCharacter::DettachFromRope()
+{
+	SCOPE_SWING_STAT(DettachFromRope);
+	FSPSwingAllocationScope AllocationScope;
+
+	// A swinging character is detached from OnMovementModeChanged, a thrown rope that has not attached yet is dropped right away
+	const bool bWasSwinging = IsSwinging();
+	BaseCharacterMovementComponent->StopSwinging();
+	if (!bWasSwinging)
+	{
+		OnRopeDetached();
+	}
+}
+
+void ASwingProjCharacter::OnRep_ReplicatedSwingState()
+{
+	// Movement mode and swing state replicate independently, whichever arrives last finishes the attach
+	BaseCharacterMovementComponent->SetSwingTarget(ReplicatedSwingState);
+	if (IsSwinging() && ReplicatedSwingState.Anchor != CurrentRopeSwingAttachActor)
+	{
+		OnRopeAttached();
+	}
+}
+
+void ASwingProjCharacter::OnRep_ReplicatedRopeWrap()
+{
+	BaseCharacterMovementComponent->SetRopeWrapFromServer(ReplicatedRopeWrap);
+}
+
+void ASwingProjCharacter::SetAttachedInteractiveActor(AInteractiveActor* NewAttachedActor)
+{
+	if (AttachedInteractiveActor.Get() == NewAttachedActor)
+	{
+		return;
+	}
+
+	if (AttachedInteractiveActor.IsValid())
+	{
+		AttachedInteractiveActor->OnInteractionEnded(this);
+	}
+
+	AttachedInteractiveActor = NewAttachedActor;
+	if (IsValid(NewAttachedActor))
+	{
+		NewAttachedActor->OnInteractionStarted(this);
+	}
 }
@@ -4,40 +4,79 @@
 
 #include "CoreMinimal.h"
 #include "Actors/Interactive/InteractiveActor.h"
+#include "Components/MovementComponents/SPBaseCharacterMovementComponent.h"
 #include "GameFramework/Character.h"
+#include "Subsystems/SPAnchorCandidateSet.h"
+#include "Subsystems/SPRopePoolSubsystem.h"
 #include "SwingProjCharacter.generated.h"
 
 class USPBaseCharacterMovementComponent;
 class ARopeSwingAttachmentActor;
-class UCableComponent;
+class USPSwingReleasePredictorComponent;
+class USPSwingRecorderComponent;
+class USPAnchorVisibilityComponent;
 
 UCLASS(config=Game)
 class ASwingProjCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
+	// Replays drive the character through the same input handlers the player does
+	friend class USPSwingRecorderComponent;
+
 public:
 	ASwingProjCharacter(const FObjectInitializer& ObjectInitializer);
 
-	virtual void OnConstruction(const FTransform& Transform) override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
 	USPBaseCharacterMovementComponent* GetBaseCharacterMovementComponent() const;
 	
 	virtual void Jump() override;
+	virtual void StopJumping() override;
+
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
 
+	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+	virtual void OnRep_Controller() override;
+
+	void ThrowRope();
 	void AttachToRope();
 
+	// Called by USPHookProjectileSubsystem when the thrown hook reaches its anchor or is stopped on the way
+	void OnHookContact();
+	void OnHookMissed();
+
+	// Called on the owning client when the server did not accept its rope attach
+	void OnSwingTargetRejected();
+
+	// Identifies the character in recordings and telemetry, see FSPSwingRecordFrame::GetAnchorId. Set in BeginPlay
+	uint32 GetStableId() const { return StableId; }
+
+	// Called by the movement component whenever the rope wraps or unwraps
+	void OnRopeWrapChanged();
+
 	UFUNCTION(BlueprintCallable)
-	bool IsSwinging() const { return bIsSwinging; };
+	bool IsSwinging() const;
 	
 	UFUNCTION(BlueprintCallable)
 	FRotator GetCurrentRopeRotation() const;
 	
-	void RegisterInteractiveActor(AInteractiveActor* InteractiveActor);
-	void UnRegisterInteractiveActor(AInteractiveActor* InteractiveActor);
-	
-	TArray<AInteractiveActor*> GetCurrentAvailableInteractiveActors() const;
+	TArrayView<AInteractiveActor* const> GetCurrentAvailableInteractiveActors() const;
 	ARopeSwingAttachmentActor* GetCurrentRopeSwingAttachActor() const;
+
+	float GetRopeImpulseRatio() const { return RopeImpulseRatio; }
+	float GetThrowRopeMinCosine() const { return ThrowRopeMinCosine; }
+	float GetThrowRopeMaxDistance() const { return ThrowRopeMaxDistance; }
+	const FVector& GetCurrentRopeVector() const { return CurrentRopeVector; }
+	// Called by USPSwingManagerSubsystem while the character swings
+	void SetCurrentRopeVector(const FVector& NewRopeVector) { CurrentRopeVector = NewRopeVector; }
+
+	// True while a recorded session drives the character, live gameplay triggers are ignored then
+	bool IsDrivenBySwingRecording() const;
 	
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	float BaseTurnRate;
@@ -47,6 +86,9 @@ public:
 
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	FORCEINLINE USPSwingReleasePredictorComponent* GetSwingReleasePredictor() const { return SwingReleasePredictor; }
+	FORCEINLINE USPSwingRecorderComponent* GetSwingRecorder() const { return SwingRecorder; }
+	FORCEINLINE USPAnchorVisibilityComponent* GetAnchorVisibility() const { return AnchorVisibility; }
 
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
@@ -58,45 +100,101 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UCameraComponent* FollowCamera;
 
+	// Coiled rope on the belt, shown while the character holds no rope from USPRopePoolSubsystem
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Rope, meta = (AllowPrivateAccess = "true"))
-	UCableComponent* Rope;
+	class UStaticMeshComponent* BeltRopeMesh;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Rope)
+	class UStaticMesh* HookStaticMesh;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Rope)
+	class UMaterialInterface* RopeMaterial;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "0.01", UIMin = "0.01"))
+	float RopeWidth = 3.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+	USPSwingReleasePredictorComponent* SwingReleasePredictor;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Recording, meta = (AllowPrivateAccess = "true"))
+	USPSwingRecorderComponent* SwingRecorder;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Rope, meta = (AllowPrivateAccess = "true"))
-	class UStaticMeshComponent* HookMesh;
+	USPAnchorVisibilityComponent* AnchorVisibility;
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Rope, meta = (AllowPrivateAccess = "true"))
 	class UAnimMontage* ThrowMontage;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	float RopeImpulseRatio = 1.5f;
-	
-	virtual void Tick(float DeltaTime) override;
+
+	// Cosine of the widest angle between the camera and an anchor that can still be picked
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "-1", UIMin = "-1", ClampMax = "1", UIMax = "1"))
+	float ThrowRopeMinCosine = 0.35f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "0", UIMin = "0"))
+	float ThrowRopeMaxDistance = 1500.f;
+
+	// Score penalty of an anchor at ThrowRopeMaxDistance, the score of a perfectly aimed anchor is 1
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "0", UIMin = "0"))
+	float ThrowRopeDistanceWeight = 0.2f;
+
+	// Score bonus of the previously selected anchor
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "0", UIMin = "0"))
+	float ThrowRopeHysteresisBonus = 0.1f;
 	
 	void MoveForward(float Value);
 	void MoveRight(float Value);
 
 
 	void OnRopeAttached();
+	void OnRopeDetached();
 	
 	void DettachFromRope();
 
+	UFUNCTION()
+	void OnRep_ReplicatedSwingState();
+
+	UFUNCTION()
+	void OnRep_ReplicatedRopeWrap();
+
 	void TurnAtRate(float Rate);
 	void LookUpAtRate(float Rate);
 	
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	
 private:
-	TArray<AInteractiveActor*> AvailableInteractiveActors;
+	// Swing state for simulated proxies, the owning client and the server get it through the movement component
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedSwingState)
+	FSPRopeSwingNetState ReplicatedSwingState;
+
+	// Wrap points are only found by the server, the owning client predicts with them and simulated proxies draw them
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedRopeWrap)
+	FSPRopeWrapNetState ReplicatedRopeWrap;
+
+	FSPAnchorCandidateSet AvailableInteractiveActors;
+	void UpdateAvailableInteractiveActors();
+
+	TWeakObjectPtr<AInteractiveActor> LastSelectedInteractiveActor;
+
+	// Anchor the character hangs on, kept apart from CurrentRopeSwingAttachActor which is already set while the rope is thrown
+	TWeakObjectPtr<AInteractiveActor> AttachedInteractiveActor;
+	void SetAttachedInteractiveActor(AInteractiveActor* NewAttachedActor);
 
 	FVector CurrentRopeVector = FVector::ZeroVector;
-	float CurrentRopeLength = 0.f;
-	bool bIsRopeStretched = false;
-	bool bIsSwinging = false;
+
+	FSPRopeLease RopeLease;
+	bool LeaseRope();
+	void ReleaseRope();
+	void UpdateRopeWrapVisual();
+
+	// Anchor visibility traces and release predictions are only used by the machine that controls the character
+	void UpdateLocallyControlledTicks();
 
 	void EquipRope();
-	void ThrowRope();
 	
-	void UpdateRopeSwing(float DeltaTime);
 	ARopeSwingAttachmentActor* CurrentRopeSwingAttachActor = nullptr;
+
+	uint32 StableId = 0;
 };
 
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingSpringArmComponent.h"
+
+#include "Characters/SwingProjCharacter.h"
+#include "Engine/World.h"
+#include "SwingProj.h"
+
+DECLARE_CYCLE_STAT(TEXT("Swing Camera"), STAT_SwingCamera, STATGROUP_Swing);
+
+void USPSwingSpringArmComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	SwingCharacter = Cast<ASwingProjCharacter>(GetOwner());
+	ProbeDelegate.BindUObject(this, &USPSwingSpringArmComponent::OnProbeCompleted);
+}
+
+void USPSwingSpringArmComponent::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime)
+{
+	SCOPE_SWING_STAT(Camera);
+
+	const bool bIsSwinging = IsValid(SwingCharacter) && SwingCharacter->IsSwinging();
+	FVector TargetSwingOffset = FVector::ZeroVector;
+	if (bIsSwinging)
+	{
+		const FVector Lead = (SwingCharacter->GetVelocity() * SwingLeadTime).GetClampedToMaxSize(MaxSwingLeadDistance);
+		TargetSwingOffset = Lead + SwingCharacter->GetCurrentRopeVector() * SwingPivotBias;
+	}
+	SwingBlend = FMath::FInterpTo(SwingBlend, bIsSwinging ? 1.f : 0.f, DeltaTime, SwingInterpSpeed);
+	SwingOffset = FMath::VInterpTo(SwingOffset, TargetSwingOffset, DeltaTime, SwingInterpSpeed);
+
+	// The base arm places the unobstructed camera, swing framing only shifts its inputs for this update
+	const FVector BaseTargetOffset = TargetOffset;
+	const float BaseTargetArmLength = TargetArmLength;
+	TargetOffset += SwingOffset;
+	TargetArmLength = FMath::Lerp(TargetArmLength, SwingArmLength, SwingBlend);
+	Super::UpdateDesiredArmLocation(false, bDoLocationLag, bDoRotationLag, DeltaTime);
+	const bool bHasArm = TargetArmLength != 0.f;
+	TargetOffset = BaseTargetOffset;
+	TargetArmLength = BaseTargetArmLength;
+
+	UWorld* World = GetWorld();
+	if (!bDoTrace || !bHasArm || !ProbeDelegate.IsBound() || World == nullptr)
+	{
+		ArmFraction = 1.f;
+		return;
+	}
+
+	const FVector ArmOrigin = PreviousArmOrigin;
+	const FVector DesiredLocation = UnfixedCameraPosition;
+
+	// The probe issued last frame for this frame's arm replaces the sweep the base arm would do now
+	ArmFraction = ProbeClearFraction < ArmFraction ? ProbeClearFraction : FMath::FInterpTo(ArmFraction, ProbeClearFraction, DeltaTime, ProbeRecoverySpeed);
+	if (ArmFraction < 1.f)
+	{
+		const FTransform SocketTransform = FTransform(RelativeSocketRotation, RelativeSocketLocation) * GetComponentTransform();
+		const FTransform WorldCameraTransform(SocketTransform.GetRotation(), FMath::Lerp(ArmOrigin, DesiredLocation, ArmFraction));
+		const FTransform RelativeCameraTransform = WorldCameraTransform.GetRelativeTransform(GetComponentTransform());
+		RelativeSocketLocation = RelativeCameraTransform.GetLocation();
+		RelativeSocketRotation = RelativeCameraTransform.GetRotation();
+		bIsCameraFixed = true;
+		UpdateChildTransforms();
+	}
+
+	const FVector OwnerDelta = IsValid(GetOwner()) ? GetOwner()->GetVelocity() * DeltaTime : FVector::ZeroVector;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SwingSpringArm), false, GetOwner());
+	ProbeGeneration++;
+	World->AsyncSweepByChannel(EAsyncTraceType::Single, ArmOrigin + OwnerDelta, DesiredLocation + OwnerDelta, FQuat::Identity, ProbeChannel,
+		FCollisionShape::MakeSphere(ProbeSize), QueryParams, FCollisionResponseParams::DefaultResponseParam, &ProbeDelegate, ProbeGeneration);
+}
+
+void USPSwingSpringArmComponent::OnProbeCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (TraceDatum.UserData != ProbeGeneration)
+	{
+		return;
+	}
+
+	const bool bHasHit = TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit;
+	ProbeClearFraction = bHasHit ? TraceDatum.OutHits[0].Time : 1.f;
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "WorldCollision.h"
+#include "SPSwingSpringArmComponent.generated.h"
+
+class ASwingProjCharacter;
+
+/**
+ * Spring arm that probes for collision with an async sweep issued for the next frame, no trace runs synchronously.
+ * While the owner swings the arm is lengthened, raised towards the anchor and aimed ahead along the swing velocity.
+ */
+UCLASS(ClassGroup = Camera, meta = (BlueprintSpawnableComponent))
+class SWINGPROJ_API USPSwingSpringArmComponent : public USpringArmComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void BeginPlay() override;
+
+protected:
+	virtual void UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime) override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Camera", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingArmLength = 400.f;
+
+	// Seconds of swing velocity the arm aims ahead, offsets the location lag along the arc
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Camera", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingLeadTime = 0.15f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Camera", meta = (ClampMin = "0", UIMin = "0"))
+	float MaxSwingLeadDistance = 200.f;
+
+	// Share of the rope the arm origin is moved towards the anchor, keeps the anchor in frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Camera", meta = (ClampMin = "0", UIMin = "0", ClampMax = "1", UIMax = "1"))
+	float SwingPivotBias = 0.15f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Camera", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingInterpSpeed = 4.f;
+
+	// The arm is shortened as soon as a probe hits and extends back at this speed, so it does not pump against geometry
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = CameraCollision, meta = (ClampMin = "0", UIMin = "0"))
+	float ProbeRecoverySpeed = 6.f;
+
+private:
+	void OnProbeCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	UPROPERTY(Transient)
+	ASwingProjCharacter* SwingCharacter;
+
+	FTraceDelegate ProbeDelegate;
+	// Results of probes issued before the last one are dropped
+	uint32 ProbeGeneration = 0;
+	// Share of the arm the last probe found clear, and the smoothed share the arm is drawn at
+	float ProbeClearFraction = 1.f;
+	float ArmFraction = 1.f;
+
+	float SwingBlend = 0.f;
+	FVector SwingOffset = FVector::ZeroVector;
+};
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPAnchorVisibilityComponent.h"
+
+#include "Actors/Interactive/InteractiveActor.h"
+#include "Engine/World.h"
+#include "Subsystems/SPAnchorCandidateSet.h"
+#include "Subsystems/SPRopeAnchorSubsystem.h"
+#include "SwingProj.h"
+
+DECLARE_CYCLE_STAT(TEXT("Anchor Visibility"), STAT_SwingAnchorVisibility, STATGROUP_Swing);
+
+USPAnchorVisibilityComponent::USPAnchorVisibilityComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	// The owner turns the tick on once it is locally controlled
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void USPAnchorVisibilityComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SCOPE_SWING_STAT(AnchorVisibility);
+	RefreshTrackedAnchors();
+	IssueTraces();
+}
+
+bool USPAnchorVisibilityComponent::IsAnchorVisible(const AInteractiveActor* Anchor) const
+{
+	const FAnchorVisibility* Visibility = Cache.Find(MakeWeakObjectPtr(const_cast<AInteractiveActor*>(Anchor)));
+	return Visibility == nullptr || Visibility->bIsVisible;
+}
+
+void USPAnchorVisibilityComponent::ApplyToCandidates(FSPAnchorCandidateSet& Candidates) const
+{
+	for (int32 i = 0; i < Candidates.Num(); ++i)
+	{
+		Candidates.SetVisible(i, IsAnchorVisible(Candidates.GetActor(i)));
+	}
+}
+
+void USPAnchorVisibilityComponent::RefreshTrackedAnchors()
+{
+	USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	if (!IsValid(RopeAnchorSubsystem))
+	{
+		return;
+	}
+
+	QueryResults.Reset();
+	RopeAnchorSubsystem->GatherAvailableInteractiveActors(GetOwner()->GetActorLocation(), QueryResults);
+
+	TrackedAnchors.Reset();
+	for (AInteractiveActor* Anchor : QueryResults)
+	{
+		TrackedAnchors.Add(Anchor);
+		Cache.FindOrAdd(Anchor).LastSeenFrame = GFrameCounter;
+	}
+
+	// Anchors that left the range lose their result, they are traced again once they come back
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		if (It->Value.LastSeenFrame != GFrameCounter)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void USPAnchorVisibilityComponent::IssueTraces()
+{
+	// Results of the previous batch have been delivered at the start of this frame
+	TraceBatch.Reset();
+	TraceBatchId = (TraceBatchId + 1) & 0x00FFFFFF;
+	if (TrackedAnchors.Num() == 0)
+	{
+		return;
+	}
+
+	if (!TraceDelegate.IsBound())
+	{
+		TraceDelegate.BindUObject(this, &USPAnchorVisibilityComponent::OnTraceCompleted);
+	}
+
+	const FVector TraceStart = GetOwner()->GetActorLocation() + FVector(0.f, 0.f, TraceStartHeight);
+	const int32 NumTraces = FMath::Min3(MaxTracesPerFrame, TrackedAnchors.Num(), 255);
+	for (int32 i = 0; i < NumTraces; ++i)
+	{
+		NextAnchorIndex = NextAnchorIndex < TrackedAnchors.Num() ? NextAnchorIndex : 0;
+		AInteractiveActor* Anchor = TrackedAnchors[NextAnchorIndex++].Get();
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AnchorVisibility), false, GetOwner());
+		QueryParams.AddIgnoredActor(Anchor);
+
+		const uint32 UserData = (TraceBatchId << 8) | TraceBatch.Num();
+		TraceBatch.Add(Anchor);
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Test, TraceStart, Anchor->GetActorLocation(), TraceChannel,
+			QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, UserData);
+	}
+}
+
+void USPAnchorVisibilityComponent::OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 Slot = TraceDatum.UserData & 0xFF;
+	if ((TraceDatum.UserData >> 8) != TraceBatchId || !TraceBatch.IsValidIndex(Slot))
+	{
+		return;
+	}
+
+	FAnchorVisibility* Visibility = Cache.Find(TraceBatch[Slot]);
+	if (Visibility != nullptr)
+	{
+		// Test traces only add a hit when something blocks the line
+		Visibility->bIsVisible = TraceDatum.OutHits.Num() == 0;
+	}
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "SPAnchorVisibilityComponent.generated.h"
+
+class AInteractiveActor;
+struct FSPAnchorCandidateSet;
+
+/**
+ * Keeps line of sight results for the interactive actors around the owner.
+ * A bounded batch of async traces is issued every frame round-robin, rope throws only read the cache.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SWINGPROJ_API USPAnchorVisibilityComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USPAnchorVisibilityComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Anchors that have not been traced yet count as visible
+	bool IsAnchorVisible(const AInteractiveActor* Anchor) const;
+
+	// Writes the cached visibility of every candidate into the set
+	void ApplyToCandidates(FSPAnchorCandidateSet& Candidates) const;
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Anchor Visibility", meta = (ClampMin = "1", UIMin = "1", ClampMax = "255", UIMax = "255"))
+	int32 MaxTracesPerFrame = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Anchor Visibility")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	// Traces start this far above the owner's location, roughly at the hand that throws the rope
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Anchor Visibility")
+	float TraceStartHeight = 50.f;
+
+private:
+	struct FAnchorVisibility
+	{
+		bool bIsVisible = true;
+		uint64 LastSeenFrame = 0;
+	};
+
+	void RefreshTrackedAnchors();
+	void IssueTraces();
+	void OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	TMap<TWeakObjectPtr<AInteractiveActor>, FAnchorVisibility> Cache;
+	TArray<TWeakObjectPtr<AInteractiveActor>> TrackedAnchors;
+	TArray<AInteractiveActor*> QueryResults;
+	int32 NextAnchorIndex = 0;
+
+	// Anchors traced by the current batch, a trace's user data holds the batch in the upper bits and the slot in the low byte
+	TArray<TWeakObjectPtr<AInteractiveActor>, TInlineAllocator<8>> TraceBatch;
+	uint32 TraceBatchId = 0;
+	FTraceDelegate TraceDelegate;
+};
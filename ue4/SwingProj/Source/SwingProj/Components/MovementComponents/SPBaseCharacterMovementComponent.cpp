@@ -3,4 +3,694 @@
 
 #include "SPBaseCharacterMovementComponent.h"
 
+#include "Benchmark/SPCountingMalloc.h"
+#include "Characters/SwingProjCharacter.h"
+#include "Engine/NetConnection.h"
+#include "Simulation/SPSwingKernel.h"
+#include "Subsystems/SPHookProjectileSubsystem.h"
+#include "Subsystems/SPRopeAnchorSubsystem.h"
+#include "SwingProj.h"
+#include "Telemetry/SPSwingTelemetry.h"
+#include "UObject/CoreNet.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Swingers"), STAT_SwingActiveSwingers, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Swing Physics"), STAT_SwingPhysics, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Swing Rope Wrap"), STAT_SwingRopeWrap, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Swing Attach Validation"), STAT_SwingAttachValidation, STATGROUP_Swing);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Swing Attaches Rejected"), STAT_SwingAttachesRejected, STATGROUP_Swing);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Swing Attaches Corrected"), STAT_SwingAttachesCorrected, STATGROUP_Swing);
+
+bool FSPRopeSwingNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	UObject* AnchorObject = Anchor;
+	bOutSuccess = Map->SerializeObject(Ar, AActor::StaticClass(), AnchorObject);
+	if (Ar.IsLoading())
+	{
+		Anchor = Cast<AActor>(AnchorObject);
+	}
+
+	Ar << QuantizedRopeLength;
+	return true;
+}
+
+FSPSwingUpdateTiming USPBaseCharacterMovementComponent::SwingUpdateTiming;
+
+int32 FSPSwingAllocationScope::Depth = 0;
+
+FSPSwingAllocationScope::FSPSwingAllocationScope()
+{
+	if (Depth++ == 0)
+	{
+		StartAllocations = FSPCountingMalloc::GetNumGameThreadAllocations();
+	}
+}
+
+FSPSwingAllocationScope::~FSPSwingAllocationScope()
+{
+	if (--Depth == 0)
+	{
+		USPBaseCharacterMovementComponent::SwingUpdateTiming.NumAllocations += FSPCountingMalloc::GetNumGameThreadAllocations() - StartAllocations;
+	}
+}
+
+void USPBaseCharacterMovementComponent::SetUpdatedComponent(USceneComponent* NewUpdatedComponent)
+{
+	Super::SetUpdatedComponent(NewUpdatedComponent);
+	SwingCharacterOwner = Cast<ASwingProjCharacter>(CharacterOwner);
+}
+
+float USPBaseCharacterMovementComponent::GetMaxSpeed() const
+{
+	if (IsSwinging())
+	{
+		return MaxSwingSpeed;
+	}
+	return Super::GetMaxSpeed();
+}
+
+FNetworkPredictionData_Client* USPBaseCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		USPBaseCharacterMovementComponent* MutableThis = const_cast<USPBaseCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_SPCharacter(*this);
+	}
+	return ClientPredictionData;
+}
+
+void USPBaseCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+	bWantsToSwing = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+}
+
+void USPBaseCharacterMovementComponent::RequestSwing(AActor* Anchor, float RopeLength)
+{
+	FSPRopeSwingNetState NewSwingTarget;
+	NewSwingTarget.Anchor = Anchor;
+	NewSwingTarget.SetRopeLength(FMath::Min(RopeLength, MaxSwingRopeLength));
+	if (!NewSwingTarget.IsValid())
+	{
+		return;
+	}
+
+	SwingTarget = NewSwingTarget;
+	bWantsToSwing = true;
+
+	if (IsValid(CharacterOwner) && CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		ServerSetSwingTarget(SwingTarget, SwingThrowTimeStamp, GetPredictionData_Client_Character()->CurrentTimeStamp);
+	}
+}
+
+void USPBaseCharacterMovementComponent::SaveSwingThrowTimeStamp()
+{
+	if (IsValid(CharacterOwner) && CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		SwingThrowTimeStamp = GetPredictionData_Client_Character()->CurrentTimeStamp;
+	}
+}
+
+void USPBaseCharacterMovementComponent::StopSwinging()
+{
+	bWantsToSwing = false;
+	if (IsSwinging())
+	{
+		SetMovementMode(MOVE_Falling);
+	}
+}
+
+void USPBaseCharacterMovementComponent::SetSwingTarget(const FSPRopeSwingNetState& NewSwingTarget)
+{
+	SwingTarget = NewSwingTarget;
+	if (IsSwinging())
+	{
+		ApplySwingTarget();
+	}
+}
+
+void USPBaseCharacterMovementComponent::ServerSetSwingTarget_Implementation(const FSPRopeSwingNetState& NewSwingTarget, float ThrowTimeStamp, float AttachTimeStamp)
+{
+	FSPRopeSwingNetState ValidatedSwingTarget = NewSwingTarget;
+	if (!ValidateSwingTarget(ValidatedSwingTarget, ThrowTimeStamp, AttachTimeStamp))
+	{
+		// The client only throws without a rope, so neither side keeps one. Moves still asking for the swing find no target
+		INC_DWORD_STAT(STAT_SwingAttachesRejected);
+		SwingTarget = FSPRopeSwingNetState();
+		ClientAdjustSwingTarget(FSPRopeSwingNetState(), ThrowTimeStamp);
+		return;
+	}
+
+	SetSwingTarget(ValidatedSwingTarget);
+	if (ValidatedSwingTarget != NewSwingTarget)
+	{
+		INC_DWORD_STAT(STAT_SwingAttachesCorrected);
+		ClientAdjustSwingTarget(ValidatedSwingTarget, ThrowTimeStamp);
+	}
+}
+
+bool USPBaseCharacterMovementComponent::ServerSetSwingTarget_Validate(const FSPRopeSwingNetState& NewSwingTarget, float ThrowTimeStamp, float AttachTimeStamp)
+{
+	return NewSwingTarget.GetRopeLength() <= MaxSwingRopeLength + 1.f;
+}
+
+void USPBaseCharacterMovementComponent::ClientAdjustSwingTarget_Implementation(const FSPRopeSwingNetState& AdjustedSwingTarget, float ThrowTimeStamp)
+{
+	// The rope has been thrown again since, the verdict is about a rope that is gone
+	if (ThrowTimeStamp != SwingThrowTimeStamp)
+	{
+		return;
+	}
+
+	RebaseSavedSwingTarget(AdjustedSwingTarget);
+	if (AdjustedSwingTarget.IsValid())
+	{
+		SetSwingTarget(AdjustedSwingTarget);
+		return;
+	}
+
+	bWantsToSwing = false;
+	SwingTarget = FSPRopeSwingNetState();
+	if (IsValid(SwingCharacterOwner))
+	{
+		SwingCharacterOwner->OnSwingTargetRejected();
+	}
+}
+
+void USPBaseCharacterMovementComponent::RebaseSavedSwingTarget(const FSPRopeSwingNetState& NewSwingTarget)
+{
+	// Replays restore the swing target of every move, the requested one would come back with them
+	const AActor* RequestedAnchor = SwingTarget.Anchor;
+	FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	auto RebaseMove = [this, RequestedAnchor, &NewSwingTarget](FSavedMove_Character* Move)
+	{
+		FSavedMove_SPCharacter* SwingMove = StaticCast<FSavedMove_SPCharacter*>(Move);
+		if (SwingMove->TimeStamp > SwingThrowTimeStamp && SwingMove->SavedSwingTarget.Anchor == RequestedAnchor)
+		{
+			SwingMove->SavedSwingTarget = NewSwingTarget;
+			if (!NewSwingTarget.IsValid())
+			{
+				SwingMove->bSavedWantsToSwing = false;
+			}
+		}
+	};
+
+	for (const FSavedMovePtr& SavedMove : ClientData->SavedMoves)
+	{
+		RebaseMove(SavedMove.Get());
+	}
+	if (ClientData->PendingMove.IsValid())
+	{
+		RebaseMove(ClientData->PendingMove.Get());
+	}
+}
+
+bool USPBaseCharacterMovementComponent::ValidateSwingTarget(FSPRopeSwingNetState& InOutSwingTarget, float ThrowTimeStamp, float AttachTimeStamp)
+{
+	SCOPE_SWING_STAT(AttachValidation);
+
+	const AInteractiveActor* Anchor = Cast<AInteractiveActor>(InOutSwingTarget.Anchor);
+	const USPRopeAnchorSubsystem* RopeAnchorSubsystem = GetWorld()->GetSubsystem<USPRopeAnchorSubsystem>();
+	FSPSwingAttachClaim Claim;
+	if (!IsValid(Anchor) || Anchor->GetInteractiveActorType() != EInteractiveActorType::RopeSwingAttachment || !IsValid(RopeAnchorSubsystem)
+		|| !RopeAnchorSubsystem->GetAvailableAnchorData(Anchor, Claim.AnchorLocation, Claim.InteractionRadius))
+	{
+		return false;
+	}
+
+	// Nothing to rewind to before the first move arrived
+	if (PoseHistory.Num() == 0)
+	{
+		PoseHistory.Add(AttachTimeStamp, UpdatedComponent->GetComponentLocation(), CharacterOwner->GetControlRotation());
+	}
+
+	Claim.RopeLength = InOutSwingTarget.GetRopeLength();
+	Claim.ThrowTimeStamp = ThrowTimeStamp;
+	Claim.AttachTimeStamp = AttachTimeStamp;
+
+	FSPSwingAttachValidationParams Params;
+	if (IsValid(SwingCharacterOwner))
+	{
+		Params.MinCosine = SwingCharacterOwner->GetThrowRopeMinCosine();
+		Params.MaxThrowDistance = SwingCharacterOwner->GetThrowRopeMaxDistance();
+	}
+	// Moves and the attach travel together, the attach can only be behind the last move by about a round trip
+	const UNetConnection* NetConnection = CharacterOwner->GetNetConnection();
+	Params.MaxRewindTime = (NetConnection != nullptr ? NetConnection->AvgLag : 0.f) + SwingRewindLagMargin;
+	const USPHookProjectileSubsystem* HookProjectileSubsystem = GetWorld()->GetSubsystem<USPHookProjectileSubsystem>();
+	if (IsValid(HookProjectileSubsystem))
+	{
+		Params.HookSpeed = HookProjectileSubsystem->GetHookSpeed();
+		Params.MaxFlightTime = HookProjectileSubsystem->GetMaxFlightTime();
+	}
+	else
+	{
+		// The rope attaches as soon as it is thrown without hooks
+		Params.HookSpeed = 0.f;
+	}
+	Params.FlightTimeTolerance = SwingValidationFlightTimeTolerance;
+	Params.LocationTolerance = SwingValidationLocationTolerance;
+	Params.CosineTolerance = SwingValidationCosineTolerance;
+	Params.RopeLengthTolerance = SwingValidationRopeLengthTolerance;
+
+	float RopeLength = 0.f;
+	const ESPSwingAttachVerdict Verdict = FSPSwingAttachValidator::Validate(PoseHistory, Claim, Params, RopeLength);
+	if (Verdict == ESPSwingAttachVerdict::Corrected)
+	{
+		InOutSwingTarget.SetRopeLength(FMath::Min(RopeLength, MaxSwingRopeLength));
+	}
+	return Verdict != ESPSwingAttachVerdict::Rejected;
+}
+
+void USPBaseCharacterMovementComponent::ClientAdjustPosition_Implementation(float TimeStamp, FVector NewLoc, FVector NewVel, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+	Super::ClientAdjustPosition_Implementation(TimeStamp, NewLoc, NewVel, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+	// Moves are replayed from the corrected one on, so the wrap points have to be the ones the first replayed move started from
+	FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	if (ClientData->bUpdatePosition && IsSwinging() && ClientData->SavedMoves.Num() > 0)
+	{
+		RopeWrapPoints = StaticCast<const FSavedMove_SPCharacter*>(ClientData->SavedMoves[0].Get())->SavedRopeWrapPoints;
+		OnRopeWrapChanged();
+	}
+}
+
+void USPBaseCharacterMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+
+	// Runs on the server for every move of a remote client, the view is the one the move was sent with
+	if (IsValid(CharacterOwner) && CharacterOwner->GetLocalRole() == ROLE_Authority && UpdatedComponent)
+	{
+		PoseHistory.Add(ClientTimeStamp, UpdatedComponent->GetComponentLocation(), CharacterOwner->GetControlRotation());
+	}
+}
+
+bool USPBaseCharacterMovementComponent::IsSwinging() const
+{
+	return UpdatedComponent && MovementMode == MOVE_Custom && CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_Swinging;
+}
+
+FSPSwingStepParams USPBaseCharacterMovementComponent::GetSwingStepParams() const
+{
+	FSPSwingStepParams Params;
+	Params.SubStepTime = SwingSubStepTime;
+	Params.MaxSubSteps = MaxSwingSubSteps;
+	Params.MaxSpeed = MaxSwingSpeed;
+	return Params;
+}
+
+FVector USPBaseCharacterMovementComponent::GetSwingAnchorLocation() const
+{
+	return SwingAnchor.IsValid() ? SwingAnchor->GetActorLocation() : FVector::ZeroVector;
+}
+
+FVector USPBaseCharacterMovementComponent::GetSwingPivotLocation() const
+{
+	return RopeWrapPoints.Num() > 0 ? RopeWrapPoints.Last().Location : GetSwingAnchorLocation();
+}
+
+void USPBaseCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// Runs on the owning client and on the server for the same move, so both enter and leave the swing at the same time
+	if (bWantsToSwing && !IsSwinging() && SwingTarget.IsValid())
+	{
+		SetMovementMode(MOVE_Custom, (uint8)ECustomMovementMode::CMOVE_Swinging);
+	}
+	else if (!bWantsToSwing && IsSwinging())
+	{
+		SetMovementMode(MOVE_Falling);
+	}
+}
+
+void USPBaseCharacterMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	switch (CustomMovementMode)
+	{
+		case (uint8)ECustomMovementMode::CMOVE_Swinging:
+		{
+			SCOPE_SWING_STAT(Physics);
+			CSV_CUSTOM_STAT(Swing, SwingUpdates, 1, ECsvCustomStatOp::Accumulate);
+			FSPSwingAllocationScope AllocationScope;
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			PhysSwinging(DeltaTime, Iterations);
+			SwingUpdateTiming.Cycles += FPlatformTime::Cycles64() - StartCycles;
+			SwingUpdateTiming.NumUpdates++;
+			break;
+		}
+		default:
+		{
+			Super::PhysCustom(DeltaTime, Iterations);
+			break;
+		}
+	}
+}
+
+void USPBaseCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	// Swing state has to be up to date before Super notifies the character
+	const bool bWasSwinging = PreviousMovementMode == MOVE_Custom && PreviousCustomMode == (uint8)ECustomMovementMode::CMOVE_Swinging;
+	if (!bWasSwinging && IsSwinging())
+	{
+		INC_DWORD_STAT(STAT_SwingActiveSwingers);
+		ApplySwingTarget();
+		if (IsValid(CharacterOwner) && CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy && !bClientUpdating)
+		{
+			SwingStartTimeStamp = GetPredictionData_Client_Character()->CurrentTimeStamp;
+		}
+	}
+	else if (bWasSwinging && !IsSwinging())
+	{
+		DEC_DWORD_STAT(STAT_SwingActiveSwingers);
+		// A rope that ended on its own, e.g. by landing, has to be requested again
+		bWantsToSwing = false;
+		SwingTarget = FSPRopeSwingNetState();
+		SwingAnchor.Reset();
+		SwingRopeLength = 0.f;
+		bIsRopeStretched = false;
+		ResetRopeWrapping();
+	}
+
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+}
+
+void USPBaseCharacterMovementComponent::ApplySwingTarget()
+{
+	SwingAnchor = SwingTarget.Anchor;
+	const AInteractiveActor* InteractiveAnchor = Cast<AInteractiveActor>(SwingTarget.Anchor);
+	SwingAnchorId = IsValid(InteractiveAnchor) ? InteractiveAnchor->GetStableId() : 0;
+	SwingRopeLength = SwingTarget.GetRopeLength();
+	bIsRopeStretched = false;
+	ResetRopeWrapping();
+}
+
+void USPBaseCharacterMovementComponent::PhysSwinging(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	if (!SwingAnchor.IsValid())
+	{
+		SetMovementMode(MOVE_Falling);
+		StartNewPhysics(DeltaTime, Iterations);
+		return;
+	}
+
+	Iterations++;
+	bJustTeleported = false;
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	UnwrapRope(OldLocation);
+
+	FSPSwingState SwingState;
+	SwingState.Location = OldLocation;
+	SwingState.Velocity = Velocity;
+	SwingState.AnchorLocation = GetSwingPivotLocation();
+	SwingState.Acceleration = FVector(0.f, 0.f, GetGravityZ()) + Acceleration * SwingAirControl;
+	SwingState.RopeLength = FMath::Max(SwingRopeLength - WrappedRopeLength, 1.f);
+	SwingState.ImpulseRatio = IsValid(SwingCharacterOwner) ? FMath::Clamp(SwingCharacterOwner->GetRopeImpulseRatio(), 1.f, 2.f) : 1.f;
+	SwingState.bIsRopeStretched = bIsRopeStretched;
+
+	FSPSwingKernel::StepState(SwingState, DeltaTime, GetSwingStepParams());
+	if (FSPSwingTelemetry::IsCapturing())
+	{
+		// Everything the velocity changed by beyond gravity and input is the rope pulling
+		const FVector RopeImpulse = SwingState.Velocity - (Velocity + SwingState.Acceleration * DeltaTime);
+		FSPSwingTelemetry::Push(ESPSwingTelemetryEvent::SwingStep, IsValid(SwingCharacterOwner) ? SwingCharacterOwner->GetStableId() : 0, SwingAnchorId, SwingState.RopeLength, RopeImpulse.Size(), SwingState.Velocity.Size());
+	}
+	Velocity = SwingState.Velocity;
+	bIsRopeStretched = SwingState.bIsRopeStretched;
+
+	const FVector Delta = SwingState.Location - OldLocation;
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+	RequestRopeWrapTraces(UpdatedComponent->GetComponentLocation());
+
+	if (Hit.IsValidBlockingHit())
+	{
+		if (IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), Hit))
+		{
+			ProcessLanded(Hit, DeltaTime * (1.f - Hit.Time), Iterations);
+			return;
+		}
+
+		HandleImpact(Hit, DeltaTime, Delta);
+		SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+		if (!bJustTeleported)
+		{
+			Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / DeltaTime;
+		}
+	}
+}
+
+void USPBaseCharacterMovementComponent::ResetRopeWrapping()
+{
+	RopeWrapPoints.Reset();
+	OnRopeWrapChanged();
+}
+
+void USPBaseCharacterMovementComponent::OnRopeWrapChanged()
+{
+	UpdateWrappedRopeLength();
+	RopeWrapGeneration = (RopeWrapGeneration + 1) & 0x00FFFFFF;
+	bRopeWrapChanged = true;
+	if (IsValid(SwingCharacterOwner))
+	{
+		SwingCharacterOwner->OnRopeWrapChanged();
+	}
+}
+
+void USPBaseCharacterMovementComponent::GetRopeWrapNetState(FSPRopeWrapNetState& OutNetState) const
+{
+	// Wrap points found between two moves apply from the next one, ones unwrapped in a move from that move on
+	const bool bIsRemotelyControlled = IsValid(CharacterOwner) && CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy;
+	OutNetState.TimeStamp = bIsRemotelyControlled && HasPredictionData_Server() ? GetPredictionData_Server_Character()->CurrentClientTimeStamp : 0.f;
+
+	OutNetState.Locations.Reset(RopeWrapPoints.Num());
+	OutNetState.BendNormals.Reset(RopeWrapPoints.Num());
+	for (const FSPRopeWrapPoint& WrapPoint : RopeWrapPoints)
+	{
+		OutNetState.Locations.Add(WrapPoint.Location);
+		OutNetState.BendNormals.Add(WrapPoint.BendNormal);
+	}
+}
+
+void USPBaseCharacterMovementComponent::SetRopeWrapFromServer(const FSPRopeWrapNetState& NetState)
+{
+	const bool bIsAutonomousProxy = IsValid(CharacterOwner) && CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy;
+	if (!IsSwinging() || (bIsAutonomousProxy && NetState.TimeStamp < SwingStartTimeStamp))
+	{
+		return;
+	}
+
+	RopeWrapPoints.Reset();
+	const int32 NumWrapPoints = FMath::Min(NetState.Locations.Num(), NetState.BendNormals.Num());
+	for (int32 i = 0; i < NumWrapPoints; ++i)
+	{
+		FSPRopeWrapPoint& WrapPoint = RopeWrapPoints.AddDefaulted_GetRef();
+		WrapPoint.Location = NetState.Locations[i];
+		WrapPoint.BendNormal = NetState.BendNormals[i];
+	}
+
+	// Moves the server had not run yet are replayed from its wrap points after the next correction
+	if (bIsAutonomousProxy)
+	{
+		FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+		for (FSavedMovePtr& SavedMove : ClientData->SavedMoves)
+		{
+			if (SavedMove->TimeStamp > NetState.TimeStamp)
+			{
+				StaticCast<FSavedMove_SPCharacter*>(SavedMove.Get())->SavedRopeWrapPoints = RopeWrapPoints;
+			}
+		}
+	}
+	OnRopeWrapChanged();
+}
+
+FVector USPBaseCharacterMovementComponent::GetRopePoint(int32 Index, const FVector& SwingerLocation) const
+{
+	// Anchor, wrap points, then the swinger
+	if (Index == 0)
+	{
+		return GetSwingAnchorLocation();
+	}
+	return Index <= RopeWrapPoints.Num() ? RopeWrapPoints[Index - 1].Location : SwingerLocation;
+}
+
+void USPBaseCharacterMovementComponent::UpdateWrappedRopeLength()
+{
+	WrappedRopeLength = 0.f;
+	for (int32 i = 0; i < RopeWrapPoints.Num(); ++i)
+	{
+		WrappedRopeLength += FVector::Dist(GetRopePoint(i, FVector::ZeroVector), RopeWrapPoints[i].Location);
+	}
+}
+
+void USPBaseCharacterMovementComponent::UnwrapRope(const FVector& SwingerLocation)
+{
+	bool bHasUnwrapped = false;
+	while (RopeWrapPoints.Num() > 0)
+	{
+		const int32 LastIndex = RopeWrapPoints.Num() - 1;
+		const FVector Pivot = RopeWrapPoints[LastIndex].Location;
+		const FVector Bend = (Pivot - GetRopePoint(LastIndex, SwingerLocation)) ^ (SwingerLocation - Pivot);
+		if ((Bend | RopeWrapPoints[LastIndex].BendNormal) >= 0.f)
+		{
+			break;
+		}
+
+		RopeWrapPoints.Pop(false);
+		bHasUnwrapped = true;
+	}
+
+	if (bHasUnwrapped)
+	{
+		OnRopeWrapChanged();
+	}
+}
+
+void USPBaseCharacterMovementComponent::RequestRopeWrapTraces(const FVector& SwingerLocation)
+{
+	// One batch per frame at most, a server may run several moves of the same character in one frame.
+	// Trace results arrive on a frame that has nothing to do with client move times, so only the server wraps and replicates the result
+	if (!bEnableRopeWrapping || !SwingAnchor.IsValid() || LastRopeWrapTraceFrame == GFrameCounter || CharacterOwner->GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	const FVector AnchorLocation = SwingAnchor->GetActorLocation();
+	const bool bHasSwingerMoved = bRopeWrapChanged || !FVector::PointsAreNear(SwingerLocation, LastTracedSwingerLocation, RopeWrapRetestDistance);
+	const bool bHasAnchorMoved = bRopeWrapChanged || !FVector::PointsAreNear(AnchorLocation, LastTracedAnchorLocation, RopeWrapRetestDistance);
+	if (!bHasSwingerMoved && !bHasAnchorMoved)
+	{
+		return;
+	}
+
+	if (!RopeWrapTraceDelegate.IsBound())
+	{
+		RopeWrapTraceDelegate.BindUObject(this, &USPBaseCharacterMovementComponent::OnRopeWrapTraceCompleted);
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RopeWrap), false, CharacterOwner);
+	QueryParams.AddIgnoredActor(SwingAnchor.Get());
+
+	// Only the segments touching a moved end are traced, the ones between wrap points stay where they are
+	UWorld* World = GetWorld();
+	const int32 FreeSegment = RopeWrapPoints.Num();
+	if (bHasSwingerMoved || (bHasAnchorMoved && FreeSegment == 0))
+	{
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, GetRopePoint(FreeSegment, SwingerLocation), SwingerLocation, RopeWrapTraceChannel,
+			QueryParams, FCollisionResponseParams::DefaultResponseParam, &RopeWrapTraceDelegate, (RopeWrapGeneration << 8) | FreeSegment);
+	}
+	if (bHasAnchorMoved && FreeSegment > 0)
+	{
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, AnchorLocation, RopeWrapPoints[0].Location, RopeWrapTraceChannel,
+			QueryParams, FCollisionResponseParams::DefaultResponseParam, &RopeWrapTraceDelegate, RopeWrapGeneration << 8);
+	}
+
+	LastRopeWrapTraceFrame = GFrameCounter;
+	LastTracedSwingerLocation = SwingerLocation;
+	LastTracedAnchorLocation = AnchorLocation;
+	bRopeWrapChanged = false;
+}
+
+void USPBaseCharacterMovementComponent::OnRopeWrapTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 Segment = TraceDatum.UserData & 0xFF;
+	if ((TraceDatum.UserData >> 8) != RopeWrapGeneration || !IsSwinging() || !SwingAnchor.IsValid() || Segment > RopeWrapPoints.Num() || RopeWrapPoints.Num() >= MaxRopeWrapPoints)
+	{
+		return;
+	}
+
+	if (TraceDatum.OutHits.Num() == 0 || !TraceDatum.OutHits[0].bBlockingHit || TraceDatum.OutHits[0].bStartPenetrating)
+	{
+		return;
+	}
+
+	SCOPE_SWING_STAT(RopeWrap);
+
+	const FHitResult& Hit = TraceDatum.OutHits[0];
+	const FVector SwingerLocation = UpdatedComponent->GetComponentLocation();
+	const FVector WrapLocation = Hit.ImpactPoint + Hit.ImpactNormal * RopeWrapOffset;
+	const FVector BendNormal = ((WrapLocation - GetRopePoint(Segment, SwingerLocation)) ^ (GetRopePoint(Segment + 1, SwingerLocation) - WrapLocation)).GetSafeNormal();
+	if (BendNormal.IsZero())
+	{
+		return;
+	}
+
+	FSPRopeWrapPoint WrapPoint;
+	WrapPoint.Location = WrapLocation;
+	WrapPoint.BendNormal = BendNormal;
+	RopeWrapPoints.Insert(WrapPoint, Segment);
+	UpdateWrappedRopeLength();
+
+	if (SwingRopeLength - WrappedRopeLength < MinFreeRopeLength)
+	{
+		RopeWrapPoints.RemoveAt(Segment, 1, false);
+		UpdateWrappedRopeLength();
+		return;
+	}
+
+	OnRopeWrapChanged();
+}
+
+void FSavedMove_SPCharacter::Clear()
+{
+	Super::Clear();
+	SavedSwingTarget = FSPRopeSwingNetState();
+	bSavedWantsToSwing = 0;
+	SavedRopeWrapPoints.Reset();
+}
+
+uint8 FSavedMove_SPCharacter::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+	if (bSavedWantsToSwing)
+	{
+		Result |= FLAG_Custom_0;
+	}
+	return Result;
+}
+
+bool FSavedMove_SPCharacter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_SPCharacter* NewSPMove = StaticCast<const FSavedMove_SPCharacter*>(NewMove.Get());
+	if (bSavedWantsToSwing != NewSPMove->bSavedWantsToSwing || SavedSwingTarget != NewSPMove->SavedSwingTarget || SavedRopeWrapPoints.Num() != NewSPMove->SavedRopeWrapPoints.Num())
+	{
+		return false;
+	}
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_SPCharacter::SetMoveFor(ACharacter* InCharacter, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(InCharacter, InDeltaTime, NewAccel, ClientData);
+
+	const USPBaseCharacterMovementComponent* MovementComponent = StaticCast<USPBaseCharacterMovementComponent*>(InCharacter->GetCharacterMovement());
+	SavedSwingTarget = MovementComponent->SwingTarget;
+	bSavedWantsToSwing = MovementComponent->bWantsToSwing;
+	SavedRopeWrapPoints = MovementComponent->RopeWrapPoints;
+}
+
+void FSavedMove_SPCharacter::PrepMoveFor(ACharacter* InCharacter)
+{
+	Super::PrepMoveFor(InCharacter);
+
+	USPBaseCharacterMovementComponent* MovementComponent = StaticCast<USPBaseCharacterMovementComponent*>(InCharacter->GetCharacterMovement());
+	MovementComponent->SwingTarget = SavedSwingTarget;
+	MovementComponent->bWantsToSwing = bSavedWantsToSwing;
+}
+
+FNetworkPredictionData_Client_SPCharacter::FNetworkPredictionData_Client_SPCharacter(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_SPCharacter::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_SPCharacter());
+}
@@ -4,8 +4,109 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Simulation/SPPoseHistory.h"
+#include "WorldCollision.h"
 #include "SPBaseCharacterMovementComponent.generated.h"
 
+UENUM(BlueprintType)
+enum class ECustomMovementMode : uint8
+{
+	CMOVE_None = 0 UMETA(DisplayName = "None"),
+	CMOVE_Swinging UMETA(DisplayName = "Swinging"),
+	CMOVE_Max UMETA(Hidden)
+};
+
+/**
+ * Rope the character hangs on, sent over the network as the anchor NetGUID and a rope length quantized to 1/8 cm
+ */
+USTRUCT()
+struct FSPRopeSwingNetState
+{
+	GENERATED_BODY()
+
+	static constexpr float RopeLengthQuantization = 8.f;
+
+	UPROPERTY()
+	AActor* Anchor = nullptr;
+
+	UPROPERTY()
+	uint16 QuantizedRopeLength = 0;
+
+	void SetRopeLength(float RopeLength) { QuantizedRopeLength = (uint16)FMath::Clamp(FMath::RoundToInt(RopeLength * RopeLengthQuantization), 0, (int32)MAX_uint16); }
+	float GetRopeLength() const { return QuantizedRopeLength / RopeLengthQuantization; }
+
+	bool IsValid() const { return ::IsValid(Anchor) && QuantizedRopeLength > 0; }
+
+	bool operator==(const FSPRopeSwingNetState& Other) const { return Anchor == Other.Anchor && QuantizedRopeLength == Other.QuantizedRopeLength; }
+	bool operator!=(const FSPRopeSwingNetState& Other) const { return !(*this == Other); }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FSPRopeSwingNetState> : public TStructOpsTypeTraitsBase2<FSPRopeSwingNetState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+struct FSPRopeWrapPoint
+{
+	FVector Location = FVector::ZeroVector;
+	// Side the rope bends to, the point unwraps once the rope straightens past it
+	FVector BendNormal = FVector::ZeroVector;
+};
+
+// Ordered from the anchor towards the character
+typedef TArray<FSPRopeWrapPoint, TInlineAllocator<8>> FSPRopeWrapPoints;
+
+/**
+ * Wrap points found by the server, stamped with the last client move it ran before finding them.
+ * The owning client rebases the saved moves made after that move on them.
+ */
+USTRUCT()
+struct FSPRopeWrapNetState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float TimeStamp = 0.f;
+
+	UPROPERTY()
+	TArray<FVector_NetQuantize10> Locations;
+
+	UPROPERTY()
+	TArray<FVector_NetQuantizeNormal> BendNormals;
+};
+
+class ASwingProjCharacter;
+struct FSPSwingStepParams;
+
+// Game thread totals of PhysSwinging across all characters, sampled and reset by benchmarks
+struct FSPSwingUpdateTiming
+{
+	uint64 Cycles = 0;
+	uint32 NumUpdates = 0;
+	// Also covers rope throws, attaches, detaches, rope leases and the hook and swing manager ticks, see FSPSwingAllocationScope
+	// Only counted while FSPCountingMalloc is installed
+	uint64 NumAllocations = 0;
+};
+
+// Adds the game thread allocations made during its lifetime to SwingUpdateTiming, a scope inside another one is not counted again
+class SWINGPROJ_API FSPSwingAllocationScope
+{
+public:
+	FSPSwingAllocationScope();
+	~FSPSwingAllocationScope();
+
+private:
+	uint64 StartAllocations = 0;
+	static int32 Depth;
+};
+
 /**
  * 
  */
@@ -13,5 +114,192 @@ UCLASS()
 class SWINGPROJ_API USPBaseCharacterMovementComponent : public UCharacterMovementComponent
 {
 	GENERATED_BODY()
-	
+
+	friend class FSavedMove_SPCharacter;
+
+public:
+	virtual void SetUpdatedComponent(USceneComponent* NewUpdatedComponent) override;
+
+	virtual float GetMaxSpeed() const override;
+
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	// Predicted on the owning client and confirmed by the server through the saved move flags
+	void RequestSwing(AActor* Anchor, float RopeLength);
+	// Owning client only, the server validates the anchor against the character's pose at this time
+	void SaveSwingThrowTimeStamp();
+	void StopSwinging();
+
+	void SetSwingTarget(const FSPRopeSwingNetState& NewSwingTarget);
+	const FSPRopeSwingNetState& GetSwingTarget() const { return SwingTarget; }
+
+	UFUNCTION(BlueprintCallable, Category = "Character Movement: Swinging")
+	bool IsSwinging() const;
+
+	FVector GetSwingAnchorLocation() const;
+	// Last point the rope wraps around, the anchor itself while the rope is unobstructed
+	FVector GetSwingPivotLocation() const;
+	const FSPRopeWrapPoints& GetRopeWrapPoints() const { return RopeWrapPoints; }
+	// Only the server traces for new wrap points, clients get them through these
+	void GetRopeWrapNetState(FSPRopeWrapNetState& OutNetState) const;
+	void SetRopeWrapFromServer(const FSPRopeWrapNetState& NetState);
+	float GetSwingRopeLength() const { return SwingRopeLength; }
+	bool IsRopeStretched() const { return bIsRopeStretched; }
+
+	FSPSwingStepParams GetSwingStepParams() const;
+
+	const FSPPoseHistory& GetPoseHistory() const { return PoseHistory; }
+
+	static FSPSwingUpdateTiming SwingUpdateTiming;
+
+protected:
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+	virtual void ClientAdjustPosition_Implementation(float TimeStamp, FVector NewLoc, FVector NewVel, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerSetSwingTarget(const FSPRopeSwingNetState& NewSwingTarget, float ThrowTimeStamp, float AttachTimeStamp);
+
+	// Corrected swing target, or an invalid one when the server rejected the attach. Answers the throw made at ThrowTimeStamp
+	UFUNCTION(Client, Reliable)
+	void ClientAdjustSwingTarget(const FSPRopeSwingNetState& AdjustedSwingTarget, float ThrowTimeStamp);
+
+	// Length of a single fixed step of the rope constraint solver
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swinging", meta = (ClampMin = "0.001", UIMin = "0.001"))
+	float SwingSubStepTime = 1.f / 120.f;
+
+	// Upper bound of solver steps per frame, long frames are solved with proportionally longer steps
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swinging", meta = (ClampMin = "1", UIMin = "1"))
+	int32 MaxSwingSubSteps = 8;
+
+	// Fraction of MaxAcceleration available to player input while hanging on the rope
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swinging", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingAirControl = 0.3f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swinging", meta = (ClampMin = "0", UIMin = "0"))
+	float MaxSwingSpeed = 2500.f;
+
+	// Longest rope a client is allowed to request, has to fit the quantized length range
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swinging", meta = (ClampMin = "0", UIMin = "0", ClampMax = "8191", UIMax = "8191"))
+	float MaxSwingRopeLength = 3000.f;
+
+	// Attaches are rewound at most by the round trip time of the client's connection plus this
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swing Validation", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingRewindLagMargin = 0.1f;
+
+	// Slack for the time the hook takes to reach the anchor, the client's frames and its hook may not match the server's
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swing Validation", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingValidationFlightTimeTolerance = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swing Validation", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingValidationLocationTolerance = 50.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swing Validation", meta = (ClampMin = "0", UIMin = "0", ClampMax = "2", UIMax = "2"))
+	float SwingValidationCosineTolerance = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Swing Validation", meta = (ClampMin = "0", UIMin = "0"))
+	float SwingValidationRopeLengthTolerance = 50.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Rope Wrapping")
+	bool bEnableRopeWrapping = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Rope Wrapping")
+	TEnumAsByte<ECollisionChannel> RopeWrapTraceChannel = ECC_Visibility;
+
+	// Distance a wrap point is pushed off the surface it wraps around
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Rope Wrapping", meta = (ClampMin = "0", UIMin = "0"))
+	float RopeWrapOffset = 5.f;
+
+	// A wrap that would leave less free rope than this is ignored
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Rope Wrapping", meta = (ClampMin = "0", UIMin = "0"))
+	float MinFreeRopeLength = 50.f;
+
+	// A rope segment is traced again only once one of its ends moved further than this
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Rope Wrapping", meta = (ClampMin = "0", UIMin = "0"))
+	float RopeWrapRetestDistance = 2.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Rope Wrapping", meta = (ClampMin = "1", UIMin = "1", ClampMax = "255", UIMax = "32"))
+	int32 MaxRopeWrapPoints = 8;
+
+private:
+	void PhysSwinging(float DeltaTime, int32 Iterations);
+	void ApplySwingTarget();
+	// Server only, false when the anchor was not in reach of the client when it threw. May correct the rope length
+	bool ValidateSwingTarget(FSPRopeSwingNetState& InOutSwingTarget, float ThrowTimeStamp, float AttachTimeStamp);
+	// Owning client only, makes the saved moves of the current throw replay with the swing target the server settled on
+	void RebaseSavedSwingTarget(const FSPRopeSwingNetState& NewSwingTarget);
+
+	void ResetRopeWrapping();
+	void OnRopeWrapChanged();
+	void UnwrapRope(const FVector& SwingerLocation);
+	void RequestRopeWrapTraces(const FVector& SwingerLocation);
+	void OnRopeWrapTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	FVector GetRopePoint(int32 Index, const FVector& SwingerLocation) const;
+	void UpdateWrappedRopeLength();
+
+	ASwingProjCharacter* SwingCharacterOwner = nullptr;
+
+	FSPRopeSwingNetState SwingTarget;
+	bool bWantsToSwing = false;
+	float SwingThrowTimeStamp = 0.f;
+
+	// Server only, poses of a remotely controlled character by client move time
+	FSPPoseHistory PoseHistory;
+
+	TWeakObjectPtr<AActor> SwingAnchor;
+	// Stable id of the anchor for telemetry, 0 unless it is an interactive actor
+	uint32 SwingAnchorId = 0;
+	float SwingRopeLength = 0.f;
+	bool bIsRopeStretched = false;
+
+	// Unwrapping runs in every move on the server and the owning client alike, wrapping only on the server
+	FSPRopeWrapPoints RopeWrapPoints;
+	float WrappedRopeLength = 0.f;
+	// Owning client only, wrap points the server sent for an earlier swing are ignored
+	float SwingStartTimeStamp = 0.f;
+
+	FTraceDelegate RopeWrapTraceDelegate;
+	// Tags traces with the wrap points they were issued for, results of outdated traces are dropped
+	uint32 RopeWrapGeneration = 0;
+	uint64 LastRopeWrapTraceFrame = 0;
+	FVector LastTracedSwingerLocation = FVector::ZeroVector;
+	FVector LastTracedAnchorLocation = FVector::ZeroVector;
+	// Set when the wrap points changed, the free segment has to be traced again even if the swinger did not move
+	bool bRopeWrapChanged = true;
+};
+
+class FSavedMove_SPCharacter : public FSavedMove_Character
+{
+	typedef FSavedMove_Character Super;
+
+	// Rebases saved moves on the wrap points the server sends
+	friend class USPBaseCharacterMovementComponent;
+
+public:
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* InCharacter, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* InCharacter) override;
+
+private:
+	FSPRopeSwingNetState SavedSwingTarget;
+	uint8 bSavedWantsToSwing : 1;
+
+	// Wrap points the move started from, not restored by PrepMoveFor as replayed moves unwrap on their own.
+	// Only the first move replayed after a correction starts from them
+	FSPRopeWrapPoints SavedRopeWrapPoints;
+};
+
+class FNetworkPredictionData_Client_SPCharacter : public FNetworkPredictionData_Client_Character
+{
+	typedef FNetworkPredictionData_Client_Character Super;
+
+public:
+	FNetworkPredictionData_Client_SPCharacter(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
 };
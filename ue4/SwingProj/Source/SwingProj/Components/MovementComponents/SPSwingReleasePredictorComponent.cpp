@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingReleasePredictorComponent.h"
+
+#include "Async/Async.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PhysicsVolume.h"
+#include "SPBaseCharacterMovementComponent.h"
+#include "SwingProj.h"
+
+DECLARE_CYCLE_STAT(TEXT("Release Prediction"), STAT_SwingReleasePrediction, STATGROUP_Swing);
+
+namespace SPSwingPrediction
+{
+	// Segment index has to fit the low byte of the sweep user data
+	static constexpr int32 MaxSegments = 255;
+	static constexpr float IntegrationStepTime = 1.f / 60.f;
+}
+
+USPSwingReleasePredictorComponent::USPSwingReleasePredictorComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void USPSwingReleasePredictorComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const ACharacter* CharacterOwner = Cast<ACharacter>(GetOwner());
+	MovementComponent = IsValid(CharacterOwner) ? Cast<USPBaseCharacterMovementComponent>(CharacterOwner->GetCharacterMovement()) : nullptr;
+	SweepDelegate.BindUObject(this, &USPSwingReleasePredictorComponent::OnSweepCompleted);
+}
+
+void USPSwingReleasePredictorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!IsValid(MovementComponent) || !MovementComponent->IsSwinging())
+	{
+		StopPredicting();
+		return;
+	}
+
+	if (ArcTask.IsValid() && ArcTask.IsReady())
+	{
+		StartSweeps(ArcTask.Get());
+		ArcTask = TFuture<TArray<FVector>>();
+	}
+
+	if (ArcTask.IsValid() || NumPendingSweeps > 0)
+	{
+		return;
+	}
+
+	const bool bIsUpToDate = LatestPrediction.bIsValid
+		&& FVector::DistSquared(LatestPrediction.ReleaseLocation, MovementComponent->UpdatedComponent->GetComponentLocation()) <= FMath::Square(LocationTolerance)
+		&& FVector::DistSquared(LatestPrediction.ReleaseVelocity, MovementComponent->Velocity) <= FMath::Square(VelocityTolerance);
+	if (!bIsUpToDate)
+	{
+		StartArcTask();
+	}
+}
+
+void USPSwingReleasePredictorComponent::StartPredicting()
+{
+	SetComponentTickEnabled(true);
+}
+
+void USPSwingReleasePredictorComponent::StopPredicting()
+{
+	SetComponentTickEnabled(false);
+	LatestPrediction.bIsValid = false;
+
+	// A running arc task finishes on its own, its result is never read
+	ArcTask = TFuture<TArray<FVector>>();
+	NumPendingSweeps = 0;
+	SweepBatch = (SweepBatch + 1) & 0x00FFFFFF;
+}
+
+void USPSwingReleasePredictorComponent::StartArcTask()
+{
+	PendingPrediction = FSPSwingReleasePrediction();
+	PendingPrediction.ReleaseLocation = MovementComponent->UpdatedComponent->GetComponentLocation();
+	PendingPrediction.ReleaseVelocity = MovementComponent->Velocity;
+
+	const FVector ReleaseLocation = PendingPrediction.ReleaseLocation;
+	const FVector ReleaseVelocity = PendingPrediction.ReleaseVelocity;
+	const float GravityZ = MovementComponent->GetGravityZ();
+	const float TerminalVelocity = MovementComponent->GetPhysicsVolume()->TerminalVelocity;
+	const float SegmentTime = PredictionTimeStep;
+	const int32 NumSegments = FMath::Clamp(FMath::CeilToInt(MaxPredictionTime / PredictionTimeStep), 1, SPSwingPrediction::MaxSegments);
+
+	ArcTask = Async(EAsyncExecution::TaskGraph, [ReleaseLocation, ReleaseVelocity, GravityZ, TerminalVelocity, SegmentTime, NumSegments]()
+	{
+		SCOPE_SWING_STAT(ReleasePrediction);
+		TArray<FVector> ArcPoints;
+		ArcPoints.Reserve(NumSegments + 1);
+		ArcPoints.Add(ReleaseLocation);
+
+		// Falling is integrated the way the movement component does it, the arc is only sampled once per segment
+		const int32 NumSteps = FMath::Max(FMath::CeilToInt(SegmentTime / SPSwingPrediction::IntegrationStepTime), 1);
+		const float StepTime = SegmentTime / NumSteps;
+		FVector Location = ReleaseLocation;
+		FVector Velocity = ReleaseVelocity;
+		for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+		{
+			for (int32 Step = 0; Step < NumSteps; ++Step)
+			{
+				Velocity.Z += GravityZ * StepTime;
+				Velocity = Velocity.GetClampedToMaxSize(TerminalVelocity);
+				Location += Velocity * StepTime;
+			}
+			ArcPoints.Add(Location);
+		}
+		return ArcPoints;
+	});
+}
+
+void USPSwingReleasePredictorComponent::StartSweeps(const TArray<FVector>& ArcPoints)
+{
+	const ACharacter* CharacterOwner = MovementComponent->GetCharacterOwner();
+	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	const FCollisionShape CapsuleShape = Capsule->GetCollisionShape();
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SwingReleasePrediction), false, CharacterOwner);
+	FCollisionResponseParams ResponseParams;
+	Capsule->InitSweepCollisionParams(QueryParams, ResponseParams);
+
+	FirstHitSegment = INDEX_NONE;
+	NumPendingSweeps = ArcPoints.Num() - 1;
+	SweepBatch = (SweepBatch + 1) & 0x00FFFFFF;
+
+	UWorld* World = GetWorld();
+	for (int32 Segment = 0; Segment < NumPendingSweeps; ++Segment)
+	{
+		World->AsyncSweepByChannel(EAsyncTraceType::Single, ArcPoints[Segment], ArcPoints[Segment + 1], FQuat::Identity, Capsule->GetCollisionObjectType(),
+			CapsuleShape, QueryParams, ResponseParams, &SweepDelegate, (SweepBatch << 8) | Segment);
+	}
+}
+
+void USPSwingReleasePredictorComponent::OnSweepCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if ((TraceDatum.UserData >> 8) != SweepBatch || NumPendingSweeps == 0)
+	{
+		return;
+	}
+
+	const int32 Segment = TraceDatum.UserData & 0xFF;
+	if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit && (FirstHitSegment == INDEX_NONE || Segment < FirstHitSegment))
+	{
+		const FHitResult& Hit = TraceDatum.OutHits[0];
+		FirstHitSegment = Segment;
+		PendingPrediction.bHasLanding = true;
+		PendingPrediction.LandingLocation = Hit.Location;
+		PendingPrediction.LandingNormal = Hit.ImpactNormal;
+		PendingPrediction.TimeToLand = (Segment + Hit.Time) * PredictionTimeStep;
+		PendingPrediction.LandingActor = Hit.GetActor();
+	}
+
+	if (--NumPendingSweeps == 0)
+	{
+		FinishPrediction();
+	}
+}
+
+void USPSwingReleasePredictorComponent::FinishPrediction()
+{
+	PendingPrediction.bIsValid = true;
+	LatestPrediction = PendingPrediction;
+}
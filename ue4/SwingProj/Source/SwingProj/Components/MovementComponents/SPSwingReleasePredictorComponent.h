@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "SPSwingReleasePredictorComponent.generated.h"
+
+USTRUCT(BlueprintType)
+struct FSPSwingReleasePrediction
+{
+	GENERATED_BODY()
+
+	// False while the owner is not swinging or the first prediction is still in flight
+	UPROPERTY(BlueprintReadOnly)
+	bool bIsValid = false;
+
+	// False when the arc hits nothing within the prediction time
+	UPROPERTY(BlueprintReadOnly)
+	bool bHasLanding = false;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector LandingLocation = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector LandingNormal = FVector::UpVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	float TimeToLand = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	AActor* LandingActor = nullptr;
+
+	// Swing state the prediction was made from
+	FVector ReleaseLocation = FVector::ZeroVector;
+	FVector ReleaseVelocity = FVector::ZeroVector;
+};
+
+class USPBaseCharacterMovementComponent;
+
+/**
+ * Predicts where the owner lands when it lets go of the rope now.
+ * The arc is integrated on a background task and swept with async traces, the game thread only reads the last finished prediction.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SWINGPROJ_API USPSwingReleasePredictorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USPSwingReleasePredictorComponent();
+
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	UFUNCTION(BlueprintPure, Category = "Swing Prediction")
+	const FSPSwingReleasePrediction& GetLatestPrediction() const { return LatestPrediction; }
+
+	// The component only ticks while the owner swings
+	void StartPredicting();
+	// Drops the last prediction and everything still in flight
+	void StopPredicting();
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Prediction", meta = (ClampMin = "0.1", UIMin = "0.1"))
+	float MaxPredictionTime = 3.f;
+
+	// Length of one swept arc segment
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Prediction", meta = (ClampMin = "0.02", UIMin = "0.02"))
+	float PredictionTimeStep = 0.1f;
+
+	// The last prediction is kept while the swing state stays this close to the one it was made from
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Prediction", meta = (ClampMin = "0", UIMin = "0"))
+	float LocationTolerance = 25.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Prediction", meta = (ClampMin = "0", UIMin = "0"))
+	float VelocityTolerance = 50.f;
+
+private:
+	void StartArcTask();
+	void StartSweeps(const TArray<FVector>& ArcPoints);
+	void OnSweepCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	void FinishPrediction();
+
+	UPROPERTY(Transient)
+	USPBaseCharacterMovementComponent* MovementComponent;
+
+	UPROPERTY(Transient)
+	FSPSwingReleasePrediction LatestPrediction;
+
+	UPROPERTY(Transient)
+	FSPSwingReleasePrediction PendingPrediction;
+
+	TFuture<TArray<FVector>> ArcTask;
+	FTraceDelegate SweepDelegate;
+	int32 NumPendingSweeps = 0;
+	int32 FirstHitSegment = INDEX_NONE;
+	// Tags the sweeps of one prediction, results of an abandoned batch are ignored
+	uint32 SweepBatch = 0;
+};
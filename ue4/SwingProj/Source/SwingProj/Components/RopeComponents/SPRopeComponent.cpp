@@ -0,0 +1,735 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPRopeComponent.h"
+
+#include "DynamicMeshBuilder.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "LocalVertexFactory.h"
+#include "Materials/Material.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+#include "Subsystems/SPRopeSimulationSubsystem.h"
+#include "SwingProj.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rope Solve"), STAT_SwingRopeSolve, STATGROUP_Swing);
+
+namespace SPRope
+{
+	static constexpr int32 SimdWidth = 4;
+
+	// Share of the constraint error every Jacobi iteration moves each end of a segment, kept below 0.5 so neighbouring corrections do not overshoot
+	static constexpr float JacobiStiffness = 0.4f;
+
+	int32 GetPaddedNum(int32 NumParticles)
+	{
+		return Align(NumParticles, SimdWidth) + SimdWidth;
+	}
+}
+
+/** Render data of one frame, particle positions in component space */
+struct FSPRopeDynamicData
+{
+	TArray<FVector> Points;
+};
+
+class FSPRopeSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	FSPRopeSceneProxy(USPRopeComponent* Component)
+		: FPrimitiveSceneProxy(Component)
+		, Material(nullptr)
+		, VertexFactory(GetScene().GetFeatureLevel(), "FSPRopeSceneProxy")
+		, MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+		, MaxNumPoints(Component->NumSegments + 1 + USPRopeComponent::MaxWrapPoints)
+		, NumSides(Component->NumSides)
+		, RopeWidth(Component->RopeWidth)
+		, TileMaterial(Component->TileMaterial)
+	{
+		VertexBuffers.InitWithDummyData(&VertexFactory, GetVertexCount(MaxNumPoints), 2);
+
+		IndexBuffer.Indices.SetNumZeroed(GetIndexCount(MaxNumPoints));
+		BeginInitResource(&IndexBuffer);
+
+		Material = Component->GetMaterial(0);
+		if (Material == nullptr)
+		{
+			Material = UMaterial::GetDefaultMaterial(MD_Surface);
+		}
+	}
+
+	virtual ~FSPRopeSceneProxy()
+	{
+		VertexBuffers.PositionVertexBuffer.ReleaseResource();
+		VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+		VertexBuffers.ColorVertexBuffer.ReleaseResource();
+		IndexBuffer.ReleaseResource();
+		VertexFactory.ReleaseResource();
+	}
+
+	void SetDynamicData_RenderThread(FSPRopeDynamicData* NewDynamicData)
+	{
+		check(IsInRenderingThread());
+
+		NumPoints = FMath::Min(NewDynamicData->Points.Num(), MaxNumPoints);
+		if (NumPoints >= 2)
+		{
+			BuildRopeMesh(NewDynamicData->Points);
+		}
+		delete NewDynamicData;
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		if (NumPoints < 2)
+		{
+			return;
+		}
+
+		FMaterialRenderProxy* MaterialProxy = Material->GetRenderProxy();
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+		{
+			if ((VisibilityMap & (1 << ViewIndex)) == 0)
+			{
+				continue;
+			}
+
+			FMeshBatch& Mesh = Collector.AllocateMesh();
+			FMeshBatchElement& BatchElement = Mesh.Elements[0];
+			BatchElement.IndexBuffer = &IndexBuffer;
+			Mesh.bWireframe = false;
+			Mesh.VertexFactory = &VertexFactory;
+			Mesh.MaterialRenderProxy = MaterialProxy;
+
+			bool bHasPrecomputedVolumetricLightmap;
+			FMatrix PreviousLocalToWorld;
+			int32 SingleCaptureIndex;
+			bool bOutputVelocity;
+			GetScene().GetPrimitiveUniformShaderParameters_RenderThread(GetPrimitiveSceneInfo(), bHasPrecomputedVolumetricLightmap, PreviousLocalToWorld, SingleCaptureIndex, bOutputVelocity);
+
+			FDynamicPrimitiveUniformBuffer& DynamicPrimitiveUniformBuffer = Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+			DynamicPrimitiveUniformBuffer.Set(GetLocalToWorld(), PreviousLocalToWorld, GetBounds(), GetLocalBounds(), true, bHasPrecomputedVolumetricLightmap, DrawsVelocity(), bOutputVelocity);
+			BatchElement.PrimitiveUniformBufferResource = &DynamicPrimitiveUniformBuffer.UniformBuffer;
+
+			BatchElement.FirstIndex = 0;
+			BatchElement.NumPrimitives = GetIndexCount(NumPoints) / 3;
+			BatchElement.MinVertexIndex = 0;
+			BatchElement.MaxVertexIndex = GetVertexCount(NumPoints) - 1;
+			Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+			Mesh.Type = PT_TriangleList;
+			Mesh.DepthPriorityGroup = SDPG_World;
+			Mesh.bCanApplyViewModeOverrides = false;
+			Collector.AddMesh(ViewIndex, Mesh);
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bShadowRelevance = IsShadowCast(View);
+		Result.bDynamicRelevance = true;
+		MaterialRelevance.SetPrimitiveViewRelevance(Result);
+		return Result;
+	}
+
+	virtual bool CanBeOccluded() const override
+	{
+		return !MaterialRelevance.bDisableDepthTest;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override { return sizeof(*this) + GetAllocatedSize(); }
+
+	uint32 GetAllocatedSize() const { return FPrimitiveSceneProxy::GetAllocatedSize(); }
+
+private:
+	int32 GetVertexCount(int32 InNumPoints) const { return InNumPoints * (NumSides + 1); }
+	int32 GetIndexCount(int32 InNumPoints) const { return (InNumPoints - 1) * NumSides * 6; }
+
+	void BuildRopeMesh(const TArray<FVector>& Points)
+	{
+		const float Radius = RopeWidth * 0.5f;
+		const int32 VertexCount = GetVertexCount(NumPoints);
+
+		for (int32 PointIndex = 0; PointIndex < NumPoints; PointIndex++)
+		{
+			const FVector& Point = Points[PointIndex];
+			const FVector Forward = (PointIndex == 0 ? Points[1] - Point : Point - Points[PointIndex - 1]).GetSafeNormal();
+			FVector Right, Up;
+			Forward.FindBestAxisVectors(Right, Up);
+
+			const float AlongFraction = PointIndex / (float)(NumPoints - 1);
+			for (int32 SideIndex = 0; SideIndex <= NumSides; SideIndex++)
+			{
+				const float Angle = 2.f * PI * SideIndex / NumSides;
+				const FVector Normal = Right * FMath::Cos(Angle) + Up * FMath::Sin(Angle);
+				const int32 VertexIndex = PointIndex * (NumSides + 1) + SideIndex;
+
+				VertexBuffers.PositionVertexBuffer.VertexPosition(VertexIndex) = Point + Normal * Radius;
+				VertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(VertexIndex, Forward, FVector::CrossProduct(Normal, Forward), Normal);
+				VertexBuffers.StaticMeshVertexBuffer.SetVertexUV(VertexIndex, 0, FVector2D(AlongFraction * TileMaterial, SideIndex / (float)NumSides));
+				VertexBuffers.ColorVertexBuffer.VertexColor(VertexIndex) = FColor::White;
+			}
+		}
+
+		int32 Index = 0;
+		for (int32 PointIndex = 0; PointIndex < NumPoints - 1; PointIndex++)
+		{
+			for (int32 SideIndex = 0; SideIndex < NumSides; SideIndex++)
+			{
+				const int32 TopLeft = PointIndex * (NumSides + 1) + SideIndex;
+				const int32 BottomLeft = TopLeft + NumSides + 1;
+				IndexBuffer.Indices[Index++] = TopLeft;
+				IndexBuffer.Indices[Index++] = BottomLeft;
+				IndexBuffer.Indices[Index++] = TopLeft + 1;
+				IndexBuffer.Indices[Index++] = TopLeft + 1;
+				IndexBuffer.Indices[Index++] = BottomLeft;
+				IndexBuffer.Indices[Index++] = BottomLeft + 1;
+			}
+		}
+
+		CopyToRHI(VertexBuffers.PositionVertexBuffer.VertexBufferRHI, VertexBuffers.PositionVertexBuffer.GetVertexData(), VertexCount * VertexBuffers.PositionVertexBuffer.GetStride());
+		CopyToRHI(VertexBuffers.ColorVertexBuffer.VertexBufferRHI, VertexBuffers.ColorVertexBuffer.GetVertexData(), VertexCount * VertexBuffers.ColorVertexBuffer.GetStride());
+		CopyToRHI(VertexBuffers.StaticMeshVertexBuffer.TangentsVertexBuffer.VertexBufferRHI, VertexBuffers.StaticMeshVertexBuffer.GetTangentData(), VertexBuffers.StaticMeshVertexBuffer.GetTangentSize());
+		CopyToRHI(VertexBuffers.StaticMeshVertexBuffer.TexCoordVertexBuffer.VertexBufferRHI, VertexBuffers.StaticMeshVertexBuffer.GetTexCoordData(), VertexBuffers.StaticMeshVertexBuffer.GetTexCoordSize());
+
+		void* IndexBufferData = RHILockIndexBuffer(IndexBuffer.IndexBufferRHI, 0, IndexBuffer.Indices.Num() * sizeof(int32), RLM_WriteOnly);
+		FMemory::Memcpy(IndexBufferData, &IndexBuffer.Indices[0], IndexBuffer.Indices.Num() * sizeof(int32));
+		RHIUnlockIndexBuffer(IndexBuffer.IndexBufferRHI);
+	}
+
+	static void CopyToRHI(FVertexBufferRHIRef& VertexBufferRHI, const void* Data, uint32 Size)
+	{
+		void* BufferData = RHILockVertexBuffer(VertexBufferRHI, 0, Size, RLM_WriteOnly);
+		FMemory::Memcpy(BufferData, Data, Size);
+		RHIUnlockVertexBuffer(VertexBufferRHI);
+	}
+
+	UMaterialInterface* Material;
+	FStaticMeshVertexBuffers VertexBuffers;
+	FDynamicMeshIndexBuffer32 IndexBuffer;
+	FLocalVertexFactory VertexFactory;
+	FMaterialRelevance MaterialRelevance;
+
+	const int32 MaxNumPoints;
+	const int32 NumSides;
+	const float RopeWidth;
+	const float TileMaterial;
+	int32 NumPoints = 0;
+};
+
+USPRopeComponent::USPRopeComponent()
+{
+	// Only the editor preview ticks, see OnRegister
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	bTickInEditor = true;
+	bAutoActivate = true;
+
+	SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+}
+
+void USPRopeComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	SimulatedSegments = GetDesiredNumSegments();
+	AllocateParticles();
+	ResetParticles();
+
+	// Game worlds step every visible rope in one batch, the own tick only keeps the editor preview alive
+	USPRopeSimulationSubsystem* RopeSimulationSubsystem = GetWorld()->IsGameWorld() ? GetWorld()->GetSubsystem<USPRopeSimulationSubsystem>() : nullptr;
+	if (IsValid(RopeSimulationSubsystem))
+	{
+		bUsesSimulationSubsystem = true;
+		UpdateSimulationRegistration();
+	}
+	else
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void USPRopeComponent::OnVisibilityChanged()
+{
+	Super::OnVisibilityChanged();
+	if (bUsesSimulationSubsystem && IsRegistered())
+	{
+		UpdateSimulationRegistration();
+	}
+}
+
+void USPRopeComponent::UpdateSimulationRegistration()
+{
+	// Hidden ropes, e.g. pooled ones, cost nothing per frame
+	USPRopeSimulationSubsystem* RopeSimulationSubsystem = GetWorld()->GetSubsystem<USPRopeSimulationSubsystem>();
+	const bool bShouldBeSimulated = IsValid(RopeSimulationSubsystem) && IsVisible();
+	if (bShouldBeSimulated == bIsSimulatedBySubsystem)
+	{
+		return;
+	}
+
+	bIsSimulatedBySubsystem = bShouldBeSimulated;
+	if (bShouldBeSimulated)
+	{
+		ResetParticles();
+		RopeSimulationSubsystem->RegisterRope(this);
+	}
+	else if (IsValid(RopeSimulationSubsystem))
+	{
+		RopeSimulationSubsystem->UnregisterRope(this);
+	}
+}
+
+void USPRopeComponent::OnUnregister()
+{
+	if (bIsSimulatedBySubsystem)
+	{
+		USPRopeSimulationSubsystem* RopeSimulationSubsystem = GetWorld()->GetSubsystem<USPRopeSimulationSubsystem>();
+		if (IsValid(RopeSimulationSubsystem))
+		{
+			RopeSimulationSubsystem->UnregisterRope(this);
+		}
+		bIsSimulatedBySubsystem = false;
+	}
+	Super::OnUnregister();
+}
+
+void USPRopeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bUsesSimulationSubsystem)
+	{
+		PreSimulate();
+		if (!IsAtRest())
+		{
+			Simulate(DeltaTime);
+			PostSimulate();
+		}
+	}
+}
+
+void USPRopeComponent::SetAttachEndToComponent(USceneComponent* Component, FName SocketName)
+{
+	AttachEndComponent = Component;
+	AttachEndSocket = SocketName;
+}
+
+void USPRopeComponent::SetWrapPoints(TArrayView<const FVector> Points)
+{
+	// Points closest to the start matter most, the ones past the limit are cut short
+	const int32 FirstPoint = FMath::Max(Points.Num() - MaxWrapPoints, 0);
+	WrapPoints.Reset();
+	WrapPoints.Append(Points.GetData() + FirstPoint, Points.Num() - FirstPoint);
+	WakeUp();
+}
+
+void USPRopeComponent::AllocateParticles()
+{
+	const int32 PaddedNum = SPRope::GetPaddedNum(GetNumParticles());
+	PositionsX.SetNumZeroed(PaddedNum);
+	PositionsY.SetNumZeroed(PaddedNum);
+	PositionsZ.SetNumZeroed(PaddedNum);
+	PreviousX.SetNumZeroed(PaddedNum);
+	PreviousY.SetNumZeroed(PaddedNum);
+	PreviousZ.SetNumZeroed(PaddedNum);
+	CorrectionsX.SetNumZeroed(PaddedNum + SPRope::SimdWidth);
+	CorrectionsY.SetNumZeroed(PaddedNum + SPRope::SimdWidth);
+	CorrectionsZ.SetNumZeroed(PaddedNum + SPRope::SimdWidth);
+}
+
+void USPRopeComponent::ResetParticles()
+{
+	UpdateEndpoints();
+
+	const FVector RopeEnd = GetSimulatedEndLocation();
+	for (int32 i = 0; i < PositionsX.Num(); ++i)
+	{
+		const FVector Location = FMath::Lerp(StartLocation, RopeEnd, FMath::Min(i, SimulatedSegments) / (float)SimulatedSegments);
+		PositionsX[i] = PreviousX[i] = Location.X;
+		PositionsY[i] = PreviousY[i] = Location.Y;
+		PositionsZ[i] = PreviousZ[i] = Location.Z;
+	}
+	TimeRemainder = 0.f;
+	UpdateParticleBounds();
+	WakeUp();
+}
+
+void USPRopeComponent::ResampleParticles(int32 NewNumSegments)
+{
+	TArray<FVector> OldLocations;
+	GetParticleLocations(OldLocations);
+	const int32 OldNumSegments = SimulatedSegments;
+
+	SimulatedSegments = NewNumSegments;
+	AllocateParticles();
+
+	// Velocities are dropped, a LOD switch only happens at a distance where nobody sees it
+	for (int32 i = 0; i < PositionsX.Num(); ++i)
+	{
+		const float OldIndex = FMath::Min(i, SimulatedSegments) * OldNumSegments / (float)SimulatedSegments;
+		const int32 LowerIndex = FMath::Min(FMath::FloorToInt(OldIndex), OldNumSegments);
+		const int32 UpperIndex = FMath::Min(LowerIndex + 1, OldNumSegments);
+		const FVector Location = FMath::Lerp(OldLocations[LowerIndex], OldLocations[UpperIndex], OldIndex - LowerIndex);
+		PositionsX[i] = PreviousX[i] = Location.X;
+		PositionsY[i] = PreviousY[i] = Location.Y;
+		PositionsZ[i] = PreviousZ[i] = Location.Z;
+	}
+	UpdateParticleBounds();
+}
+
+void USPRopeComponent::SetSimulationEnabled(bool bEnabled)
+{
+	bIsSimulationEnabled = bEnabled;
+	if (!bIsSimulationEnabled && IsSimulatedLOD())
+	{
+		SetLOD(ESPRopeLOD::Straight);
+	}
+}
+
+void USPRopeComponent::UpdateLOD(float ViewDistanceSquared)
+{
+	ESPRopeLOD NewLOD = ESPRopeLOD::Full;
+	if (!WasRecentlyRendered(FreezeWhenHiddenTime))
+	{
+		NewLOD = ESPRopeLOD::Frozen;
+	}
+	else if (!bIsSimulationEnabled || ViewDistanceSquared > FMath::Square(StraightLODDistance))
+	{
+		NewLOD = ESPRopeLOD::Straight;
+	}
+	else if (ViewDistanceSquared > FMath::Square(ReducedLODDistance))
+	{
+		NewLOD = ESPRopeLOD::Reduced;
+	}
+	SetLOD(NewLOD);
+}
+
+void USPRopeComponent::SetLOD(ESPRopeLOD NewLOD)
+{
+	if (NewLOD == CurrentLOD)
+	{
+		return;
+	}
+
+	const bool bWasSimulated = IsSimulatedLOD();
+	CurrentLOD = NewLOD;
+	WakeUp();
+	if (IsSimulatedLOD() && !bWasSimulated)
+	{
+		// The old particles may be far from the ends by now, start again from a straight rope
+		SimulatedSegments = GetDesiredNumSegments();
+		AllocateParticles();
+		ResetParticles();
+	}
+}
+
+FVector USPRopeComponent::GetRopeEndLocation() const
+{
+	return bIsEndAttached ? EndLocation : StartLocation - FVector(0.f, 0.f, RopeLength);
+}
+
+void USPRopeComponent::PreSimulate()
+{
+	UpdateEndpoints();
+
+	const FTransform& RopeTransform = GetComponentTransform();
+	const FVector RopeEndLocation = GetRopeEndLocation();
+	if (!RopeTransform.Equals(LastRenderTransform) || !RopeEndLocation.Equals(LastRopeEndLocation))
+	{
+		LastRenderTransform = RopeTransform;
+		LastRopeEndLocation = RopeEndLocation;
+		WakeUp();
+	}
+
+	if (bIsAtRest)
+	{
+		return;
+	}
+
+	if (!IsSimulatedLOD())
+	{
+		ParticleBounds = FBox(ForceInit) + StartLocation + GetRopeEndLocation();
+		AddWrapPointBounds();
+		return;
+	}
+
+	const int32 DesiredNumSegments = GetDesiredNumSegments();
+	if (SimulatedSegments != DesiredNumSegments)
+	{
+		ResampleParticles(DesiredNumSegments);
+	}
+}
+
+void USPRopeComponent::UpdateEndpoints()
+{
+	StartLocation = GetComponentLocation();
+	bIsEndAttached = AttachEndComponent.IsValid();
+	if (bIsEndAttached)
+	{
+		EndLocation = AttachEndComponent->GetSocketLocation(AttachEndSocket);
+	}
+
+	WrappedLength = 0.f;
+	if (HasWrapPoints())
+	{
+		FVector PreviousPoint = EndLocation;
+		for (const FVector& WrapPoint : WrapPoints)
+		{
+			WrappedLength += FVector::Dist(PreviousPoint, WrapPoint);
+			PreviousPoint = WrapPoint;
+		}
+	}
+
+	const UWorld* World = GetWorld();
+	GravityZ = IsValid(World) ? World->GetGravityZ() : UPhysicsSettings::Get()->DefaultGravityZ;
+}
+
+void USPRopeComponent::Simulate(float DeltaTime)
+{
+	if (!IsSimulatedLOD())
+	{
+		return;
+	}
+
+	SCOPE_SWING_STAT(RopeSolve);
+
+	const int32 NumIterations = CurrentLOD == ESPRopeLOD::Reduced ? FMath::Min(ReducedLODSolverIterations, SolverIterations) : SolverIterations;
+	TimeRemainder += DeltaTime;
+
+	int32 NumSteps = 0;
+	while (TimeRemainder >= SubstepTime && NumSteps < MaxSubsteps)
+	{
+		IntegrateParticles(SubstepTime);
+		PinEndpoints();
+		SolveDistanceConstraints(NumIterations);
+		TimeRemainder -= SubstepTime;
+		++NumSteps;
+	}
+
+	// A long hitch is not caught up with, the rope just lags behind for one frame
+	TimeRemainder = FMath::Min(TimeRemainder, SubstepTime);
+
+	PinEndpoints();
+	UpdateParticleBounds();
+
+	if (NumSteps > 0)
+	{
+		const bool bIsSettled = GetMaxStepDistanceSquared() <= FMath::Square(SleepSpeed * SubstepTime);
+		RestTime = bIsSettled ? RestTime + DeltaTime : 0.f;
+	}
+}
+
+void USPRopeComponent::PostSimulate()
+{
+	UpdateBounds();
+	MarkRenderTransformDirty();
+	if (CurrentLOD != ESPRopeLOD::Frozen)
+	{
+		MarkRenderDynamicDataDirty();
+	}
+
+	// Straight and frozen ropes only change with their ends
+	bIsAtRest = !IsSimulatedLOD() || RestTime >= SleepTime;
+}
+
+void USPRopeComponent::IntegrateParticles(float StepTime)
+{
+	const VectorRegister Retention = VectorSetFloat1(VelocityRetention);
+	const VectorRegister GravityStep = VectorSetFloat1(GravityZ * StepTime * StepTime);
+
+	const int32 NumParticles = GetNumParticles();
+	for (int32 i = 0; i < NumParticles; i += SPRope::SimdWidth)
+	{
+		const VectorRegister X = VectorLoad(&PositionsX[i]);
+		const VectorRegister Y = VectorLoad(&PositionsY[i]);
+		const VectorRegister Z = VectorLoad(&PositionsZ[i]);
+
+		VectorStore(VectorMultiplyAdd(VectorSubtract(X, VectorLoad(&PreviousX[i])), Retention, X), &PositionsX[i]);
+		VectorStore(VectorMultiplyAdd(VectorSubtract(Y, VectorLoad(&PreviousY[i])), Retention, Y), &PositionsY[i]);
+		VectorStore(VectorAdd(VectorMultiplyAdd(VectorSubtract(Z, VectorLoad(&PreviousZ[i])), Retention, Z), GravityStep), &PositionsZ[i]);
+
+		VectorStore(X, &PreviousX[i]);
+		VectorStore(Y, &PreviousY[i]);
+		VectorStore(Z, &PreviousZ[i]);
+	}
+}
+
+void USPRopeComponent::SolveDistanceConstraints(int32 NumIterations)
+{
+	// Jacobi iterations: every constraint is evaluated against the same positions, so four of them fit one register.
+	// Correction of segment i is stored at i + 1, a particle then moves by its right minus its left segment correction.
+	const VectorRegister RestLength = VectorSetFloat1(GetSimulatedRopeLength() / SimulatedSegments);
+	const VectorRegister Stiffness = VectorSetFloat1(SPRope::JacobiStiffness);
+	const VectorRegister One = VectorOne();
+	const VectorRegister MinLengthSquared = VectorSetFloat1(KINDA_SMALL_NUMBER);
+
+	const int32 NumParticles = GetNumParticles();
+	const int32 NumConstraints = SimulatedSegments;
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		for (int32 i = 0; i < NumConstraints; i += SPRope::SimdWidth)
+		{
+			const VectorRegister DeltaX = VectorSubtract(VectorLoad(&PositionsX[i + 1]), VectorLoad(&PositionsX[i]));
+			const VectorRegister DeltaY = VectorSubtract(VectorLoad(&PositionsY[i + 1]), VectorLoad(&PositionsY[i]));
+			const VectorRegister DeltaZ = VectorSubtract(VectorLoad(&PositionsZ[i + 1]), VectorLoad(&PositionsZ[i]));
+
+			const VectorRegister LengthSquared = VectorMultiplyAdd(DeltaZ, DeltaZ, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaX, DeltaX)));
+			const VectorRegister InvLength = VectorReciprocalSqrt(VectorMax(LengthSquared, MinLengthSquared));
+			const VectorRegister Factor = VectorMultiply(VectorSubtract(One, VectorMultiply(RestLength, InvLength)), Stiffness);
+
+			VectorStore(VectorMultiply(DeltaX, Factor), &CorrectionsX[i + 1]);
+			VectorStore(VectorMultiply(DeltaY, Factor), &CorrectionsY[i + 1]);
+			VectorStore(VectorMultiply(DeltaZ, Factor), &CorrectionsZ[i + 1]);
+		}
+
+		// Lanes past the last segment were computed from padding
+		CorrectionsX[0] = CorrectionsY[0] = CorrectionsZ[0] = 0.f;
+		for (int32 i = NumConstraints + 1; i < CorrectionsX.Num(); ++i)
+		{
+			CorrectionsX[i] = CorrectionsY[i] = CorrectionsZ[i] = 0.f;
+		}
+
+		for (int32 i = 0; i < NumParticles; i += SPRope::SimdWidth)
+		{
+			VectorStore(VectorAdd(VectorLoad(&PositionsX[i]), VectorSubtract(VectorLoad(&CorrectionsX[i + 1]), VectorLoad(&CorrectionsX[i]))), &PositionsX[i]);
+			VectorStore(VectorAdd(VectorLoad(&PositionsY[i]), VectorSubtract(VectorLoad(&CorrectionsY[i + 1]), VectorLoad(&CorrectionsY[i]))), &PositionsY[i]);
+			VectorStore(VectorAdd(VectorLoad(&PositionsZ[i]), VectorSubtract(VectorLoad(&CorrectionsZ[i + 1]), VectorLoad(&CorrectionsZ[i]))), &PositionsZ[i]);
+		}
+
+		PinEndpoints();
+	}
+}
+
+void USPRopeComponent::PinEndpoints()
+{
+	PositionsX[0] = PreviousX[0] = StartLocation.X;
+	PositionsY[0] = PreviousY[0] = StartLocation.Y;
+	PositionsZ[0] = PreviousZ[0] = StartLocation.Z;
+
+	if (bIsEndAttached)
+	{
+		const int32 LastIndex = GetNumParticles() - 1;
+		const FVector SimulatedEndLocation = GetSimulatedEndLocation();
+		PositionsX[LastIndex] = PreviousX[LastIndex] = SimulatedEndLocation.X;
+		PositionsY[LastIndex] = PreviousY[LastIndex] = SimulatedEndLocation.Y;
+		PositionsZ[LastIndex] = PreviousZ[LastIndex] = SimulatedEndLocation.Z;
+	}
+}
+
+void USPRopeComponent::UpdateParticleBounds()
+{
+	ParticleBounds.Init();
+	const int32 NumParticles = GetNumParticles();
+	for (int32 i = 0; i < NumParticles; ++i)
+	{
+		ParticleBounds += FVector(PositionsX[i], PositionsY[i], PositionsZ[i]);
+	}
+	AddWrapPointBounds();
+}
+
+void USPRopeComponent::AddWrapPointBounds()
+{
+	if (HasWrapPoints())
+	{
+		for (const FVector& WrapPoint : WrapPoints)
+		{
+			ParticleBounds += WrapPoint;
+		}
+		ParticleBounds += EndLocation;
+	}
+}
+
+float USPRopeComponent::GetMaxStepDistanceSquared() const
+{
+	// Previous positions are the ones before the last substep
+	float MaxStepDistanceSquared = 0.f;
+	const int32 NumParticles = GetNumParticles();
+	for (int32 i = 0; i < NumParticles; ++i)
+	{
+		const float StepDistanceSquared = FMath::Square(PositionsX[i] - PreviousX[i]) + FMath::Square(PositionsY[i] - PreviousY[i]) + FMath::Square(PositionsZ[i] - PreviousZ[i]);
+		MaxStepDistanceSquared = FMath::Max(MaxStepDistanceSquared, StepDistanceSquared);
+	}
+	return MaxStepDistanceSquared;
+}
+
+void USPRopeComponent::GetParticleLocations(TArray<FVector>& OutLocations) const
+{
+	const int32 NumParticles = GetNumParticles();
+	OutLocations.SetNumUninitialized(NumParticles);
+	for (int32 i = 0; i < NumParticles; ++i)
+	{
+		OutLocations[i] = FVector(PositionsX[i], PositionsY[i], PositionsZ[i]);
+	}
+}
+
+FBoxSphereBounds USPRopeComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (ParticleBounds.IsValid)
+	{
+		return FBoxSphereBounds(ParticleBounds.ExpandBy(RopeWidth));
+	}
+	return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector(RopeWidth), RopeWidth);
+}
+
+FPrimitiveSceneProxy* USPRopeComponent::CreateSceneProxy()
+{
+	return new FSPRopeSceneProxy(this);
+}
+
+void USPRopeComponent::CreateRenderState_Concurrent(FRegisterComponentContext* Context)
+{
+	Super::CreateRenderState_Concurrent(Context);
+	SendRenderDynamicData_Concurrent();
+}
+
+void USPRopeComponent::SendRenderDynamicData_Concurrent()
+{
+	if (SceneProxy == nullptr)
+	{
+		return;
+	}
+
+	FSPRopeDynamicData* DynamicData = new FSPRopeDynamicData;
+	if (IsSimulatedLOD())
+	{
+		GetParticleLocations(DynamicData->Points);
+	}
+	else
+	{
+		DynamicData->Points = { StartLocation, GetSimulatedEndLocation() };
+	}
+
+	// From the last wrap point the rope runs straight around the others to its end
+	if (HasWrapPoints())
+	{
+		for (int32 i = WrapPoints.Num() - 2; i >= 0; --i)
+		{
+			DynamicData->Points.Add(WrapPoints[i]);
+		}
+		DynamicData->Points.Add(EndLocation);
+	}
+	const FTransform& RopeTransform = GetComponentTransform();
+	for (FVector& Point : DynamicData->Points)
+	{
+		Point = RopeTransform.InverseTransformPosition(Point);
+	}
+
+	FSPRopeSceneProxy* RopeSceneProxy = StaticCast<FSPRopeSceneProxy*>(SceneProxy);
+	ENQUEUE_RENDER_COMMAND(FSendSPRopeDynamicData)(
+		[RopeSceneProxy, DynamicData](FRHICommandListImmediate& RHICmdList)
+		{
+			RopeSceneProxy->SetDynamicData_RenderThread(DynamicData);
+		});
+}
@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "SPRopeComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class ESPRopeLOD : uint8
+{
+	Full,
+	Reduced,
+	// Not simulated, drawn as a single segment between its ends
+	Straight,
+	// Not simulated and the last sent shape is kept
+	Frozen,
+	Num UMETA(Hidden)
+};
+
+/**
+ * Verlet rope with particles stored as a structure of arrays and solved with SIMD kernels.
+ * In game worlds all ropes are stepped together by USPRopeSimulationSubsystem, the component itself only ticks in the editor.
+ */
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class SWINGPROJ_API USPRopeComponent : public UMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	USPRopeComponent();
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void OnVisibilityChanged() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void SendRenderDynamicData_Concurrent() override;
+	virtual void CreateRenderState_Concurrent(FRegisterComponentContext* Context) override;
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual int32 GetNumMaterials() const override { return 1; }
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+	UFUNCTION(BlueprintCallable, Category = Rope)
+	void SetRopeLength(float NewRopeLength) { RopeLength = FMath::Max(NewRopeLength, 1.f); WakeUp(); }
+
+	UFUNCTION(BlueprintPure, Category = Rope)
+	float GetRopeLength() const { return RopeLength; }
+
+	// Pins the last particle to the component or its socket, nullptr leaves the end free
+	void SetAttachEndToComponent(USceneComponent* Component, FName SocketName = NAME_None);
+
+	// Points an attached rope bends around, ordered from its end towards its start.
+	// Only the part between the start and the last wrap point is simulated, the rest is drawn straight
+	void SetWrapPoints(TArrayView<const FVector> Points);
+	static constexpr int32 MaxWrapPoints = 8;
+
+	void ResetParticles();
+
+	// Disabled ropes are drawn straight whatever their distance to the view, used for the rope hanging on the belt
+	UFUNCTION(BlueprintCallable, Category = Rope)
+	void SetSimulationEnabled(bool bEnabled);
+
+	// Game thread, picks the LOD from the distance to the closest view and the last time the rope was rendered
+	void UpdateLOD(float ViewDistanceSquared);
+	ESPRopeLOD GetLOD() const { return CurrentLOD; }
+
+	// Game thread, gathers everything Simulate needs from other objects
+	void PreSimulate();
+	// Touches only the rope's own particles, safe to run for several ropes in parallel
+	void Simulate(float DeltaTime);
+	// Game thread, hands the new particle positions to the renderer
+	void PostSimulate();
+
+	// Ends did not move and the particles settled since the last render update, Simulate and PostSimulate can be skipped
+	bool IsAtRest() const { return bIsAtRest; }
+
+	int32 GetNumParticles() const { return SimulatedSegments + 1; }
+	void GetParticleLocations(TArray<FVector>& OutLocations) const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "1", UIMin = "1"))
+	float RopeLength = 100.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "1", UIMin = "1", UIMax = "64"))
+	int32 NumSegments = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "1", UIMin = "1", UIMax = "32"))
+	int32 SolverIterations = 8;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "0.005", UIMin = "0.005", UIMax = "0.1"))
+	float SubstepTime = 0.02f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "1", UIMin = "1"))
+	int32 MaxSubsteps = 4;
+
+	// Fraction of the particle velocity kept every substep
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rope, meta = (ClampMin = "0", UIMin = "0", ClampMax = "1", UIMax = "1"))
+	float VelocityRetention = 0.99f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope LOD", meta = (ClampMin = "0", UIMin = "0"))
+	float ReducedLODDistance = 1500.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope LOD", meta = (ClampMin = "0", UIMin = "0"))
+	float StraightLODDistance = 4000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope LOD", meta = (ClampMin = "1", UIMin = "1"))
+	int32 ReducedLODSegments = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope LOD", meta = (ClampMin = "1", UIMin = "1"))
+	int32 ReducedLODSolverIterations = 3;
+
+	// Rope that has not been rendered for this long is frozen
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope LOD", meta = (ClampMin = "0", UIMin = "0"))
+	float FreezeWhenHiddenTime = 0.25f;
+
+	// Rope whose particles move slower than this for SleepTime is at rest until one of its ends moves
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope LOD", meta = (ClampMin = "0", UIMin = "0"))
+	float SleepSpeed = 2.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope LOD", meta = (ClampMin = "0", UIMin = "0"))
+	float SleepTime = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope Rendering", meta = (ClampMin = "0.01", UIMin = "0.01", UIMax = "50"))
+	float RopeWidth = 3.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope Rendering", meta = (ClampMin = "3", UIMin = "3", UIMax = "16"))
+	int32 NumSides = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rope Rendering", meta = (UIMin = "0.1", UIMax = "8"))
+	float TileMaterial = 1.f;
+
+private:
+	void AllocateParticles();
+	void UpdateSimulationRegistration();
+	void UpdateEndpoints();
+	void SetLOD(ESPRopeLOD NewLOD);
+	int32 GetDesiredNumSegments() const { return CurrentLOD == ESPRopeLOD::Reduced ? FMath::Min(ReducedLODSegments, NumSegments) : NumSegments; }
+	void ResampleParticles(int32 NewNumSegments);
+	bool IsSimulatedLOD() const { return CurrentLOD == ESPRopeLOD::Full || CurrentLOD == ESPRopeLOD::Reduced; }
+	FVector GetRopeEndLocation() const;
+	bool HasWrapPoints() const { return bIsEndAttached && WrapPoints.Num() > 0; }
+	FVector GetSimulatedEndLocation() const { return HasWrapPoints() ? WrapPoints.Last() : GetRopeEndLocation(); }
+	float GetSimulatedRopeLength() const { return FMath::Max(RopeLength - WrappedLength, 1.f); }
+	void AddWrapPointBounds();
+	void IntegrateParticles(float StepTime);
+	void SolveDistanceConstraints(int32 NumIterations);
+	void PinEndpoints();
+	void UpdateParticleBounds();
+	float GetMaxStepDistanceSquared() const;
+	void WakeUp() { bIsAtRest = false; RestTime = 0.f; }
+
+	// Structure of arrays, padded so every kernel can load four lanes past the last particle
+	TArray<float> PositionsX;
+	TArray<float> PositionsY;
+	TArray<float> PositionsZ;
+	TArray<float> PreviousX;
+	TArray<float> PreviousY;
+	TArray<float> PreviousZ;
+	TArray<float> CorrectionsX;
+	TArray<float> CorrectionsY;
+	TArray<float> CorrectionsZ;
+
+	TWeakObjectPtr<USceneComponent> AttachEndComponent;
+	FName AttachEndSocket;
+
+	FVector StartLocation = FVector::ZeroVector;
+	FVector EndLocation = FVector::ZeroVector;
+	bool bIsEndAttached = false;
+	TArray<FVector, TInlineAllocator<MaxWrapPoints>> WrapPoints;
+	float WrappedLength = 0.f;
+	float GravityZ = 0.f;
+	float TimeRemainder = 0.f;
+	FBox ParticleBounds = FBox(ForceInit);
+	bool bIsSimulatedBySubsystem = false;
+	bool bUsesSimulationSubsystem = false;
+
+	// Ends the last render update was made for
+	FTransform LastRenderTransform = FTransform::Identity;
+	FVector LastRopeEndLocation = FVector::ZeroVector;
+	float RestTime = 0.f;
+	bool bIsAtRest = false;
+
+	ESPRopeLOD CurrentLOD = ESPRopeLOD::Full;
+	int32 SimulatedSegments = 0;
+	bool bIsSimulationEnabled = true;
+};
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingGraph.h"
+
+#include "Algo/Reverse.h"
+#include "Misc/MemStack.h"
+#include "SwingProj.h"
+
+DECLARE_CYCLE_STAT(TEXT("Swing Graph Path"), STAT_SwingGraphPath, STATGROUP_Swing);
+
+int32 USPSwingGraph::FindNearestNode(const FVector& Location, float MaxDistance) const
+{
+	int32 NearestNode = INDEX_NONE;
+	float NearestDistanceSquared = FMath::Square(MaxDistance);
+	for (int32 Node = 0; Node < NodeLocations.Num(); ++Node)
+	{
+		const float DistanceSquared = FVector::DistSquared(NodeLocations[Node], Location);
+		if (DistanceSquared <= NearestDistanceSquared)
+		{
+			NearestDistanceSquared = DistanceSquared;
+			NearestNode = Node;
+		}
+	}
+	return NearestNode;
+}
+
+bool USPSwingGraph::FindPath(int32 StartNode, int32 GoalNode, TArray<int32>& OutNodes, float* OutCost) const
+{
+	SCOPE_SWING_STAT(GraphPath);
+	OutNodes.Reset();
+
+	const int32 NumNodes = NodeLocations.Num();
+	if (!NodeLocations.IsValidIndex(StartNode) || !NodeLocations.IsValidIndex(GoalNode) || EdgeOffsets.Num() != NumNodes + 1)
+	{
+		return false;
+	}
+
+	struct FOpenNode
+	{
+		int32 Node;
+		float EstimatedCost;
+
+		bool operator<(const FOpenNode& Other) const { return EstimatedCost < Other.EstimatedCost; }
+	};
+
+	// Scratch memory of one query, released when the mark goes out of scope
+	FMemMark Mark(FMemStack::Get());
+	TArray<float, TMemStackAllocator<>> Costs;
+	TArray<int32, TMemStackAllocator<>> Parents;
+	TArray<FOpenNode, TMemStackAllocator<>> OpenNodes;
+	Costs.Init(MAX_flt, NumNodes);
+	Parents.Init(INDEX_NONE, NumNodes);
+
+	const FVector& GoalLocation = NodeLocations[GoalNode];
+	const float InvMaxEdgeSpeed = MaxEdgeSpeed > 0.f ? 1.f / MaxEdgeSpeed : 0.f;
+	auto Heuristic = [&](int32 Node) { return FVector::Dist(NodeLocations[Node], GoalLocation) * InvMaxEdgeSpeed; };
+
+	Costs[StartNode] = 0.f;
+	OpenNodes.HeapPush({ StartNode, Heuristic(StartNode) });
+	while (OpenNodes.Num() > 0)
+	{
+		FOpenNode Current;
+		OpenNodes.HeapPop(Current, false);
+		if (Current.Node == GoalNode)
+		{
+			break;
+		}
+
+		// Stale entry of a node that was reached cheaper since it was pushed
+		const float CurrentCost = Costs[Current.Node];
+		if (Current.EstimatedCost > CurrentCost + Heuristic(Current.Node) + KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		for (int32 Edge = EdgeOffsets[Current.Node]; Edge < EdgeOffsets[Current.Node + 1]; ++Edge)
+		{
+			const int32 Target = EdgeTargets[Edge];
+			const float Cost = CurrentCost + EdgeCosts[Edge];
+			if (Cost < Costs[Target])
+			{
+				Costs[Target] = Cost;
+				Parents[Target] = Current.Node;
+				OpenNodes.HeapPush({ Target, Cost + Heuristic(Target) });
+			}
+		}
+	}
+
+	if (Costs[GoalNode] == MAX_flt)
+	{
+		return false;
+	}
+
+	for (int32 Node = GoalNode; Node != INDEX_NONE; Node = Parents[Node])
+	{
+		OutNodes.Add(Node);
+	}
+	Algo::Reverse(OutNodes);
+
+	if (OutCost != nullptr)
+	{
+		*OutCost = Costs[GoalNode];
+	}
+	return true;
+}
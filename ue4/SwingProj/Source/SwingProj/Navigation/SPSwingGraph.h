@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SPSwingGraph.generated.h"
+
+/**
+ * Directed graph of the rope anchors of a level, an edge means a character swinging on one anchor can let go and reach the next.
+ * Baked in the editor by ASPSwingGraphActor, edges are stored per source node in one flat array.
+ */
+UCLASS(BlueprintType)
+class SWINGPROJ_API USPSwingGraph : public UDataAsset
+{
+	GENERATED_BODY()
+
+	friend class ASPSwingGraphActor;
+
+public:
+	int32 GetNumNodes() const { return NodeLocations.Num(); }
+	const FVector& GetNodeLocation(int32 Node) const { return NodeLocations[Node]; }
+
+	int32 GetNumEdges() const { return EdgeTargets.Num(); }
+	// Edges of Node are [GetFirstEdge(Node), GetFirstEdge(Node + 1))
+	int32 GetFirstEdge(int32 Node) const { return EdgeOffsets[Node]; }
+	int32 GetEdgeTarget(int32 Edge) const { return EdgeTargets[Edge]; }
+	float GetEdgeCost(int32 Edge) const { return EdgeCosts[Edge]; }
+	// Seconds after attaching to the source anchor the character has to let go
+	float GetEdgeReleaseTime(int32 Edge) const { return EdgeReleaseTimes[Edge]; }
+
+	// INDEX_NONE when no node is closer than MaxDistance
+	int32 FindNearestNode(const FVector& Location, float MaxDistance) const;
+
+	// A* over the edge costs, OutNodes starts with StartNode and ends with GoalNode. Returns false when the goal can't be reached
+	bool FindPath(int32 StartNode, int32 GoalNode, TArray<int32>& OutNodes, float* OutCost = nullptr) const;
+
+protected:
+	UPROPERTY(VisibleAnywhere, Category = "Swing Graph")
+	TArray<FVector> NodeLocations;
+
+	// Number of nodes plus one entries
+	UPROPERTY()
+	TArray<int32> EdgeOffsets;
+
+	UPROPERTY()
+	TArray<int32> EdgeTargets;
+
+	// Seconds from attaching to the source anchor until the target anchor is in reach
+	UPROPERTY()
+	TArray<float> EdgeCosts;
+
+	UPROPERTY()
+	TArray<float> EdgeReleaseTimes;
+
+	// Fastest straight line progress over any edge, keeps the A* heuristic admissible
+	UPROPERTY(VisibleAnywhere, Category = "Swing Graph")
+	float MaxEdgeSpeed = 0.f;
+};
@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingGraphActor.h"
+
+#include "Actors/Interactive/RopeSwingAttachmentActor.h"
+#include "Actors/Interactive/SPAnchorDataActor.h"
+#include "Characters/SwingProjCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/MovementComponents/SPBaseCharacterMovementComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PhysicsVolume.h"
+#include "Navigation/SPSwingGraph.h"
+#include "Simulation/SPSwingKernel.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSwingGraph, Log, All);
+
+ASPSwingGraphActor::ASPSwingGraphActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	CharacterClass = ASwingProjCharacter::StaticClass();
+}
+
+#if WITH_EDITOR
+namespace SPSwingGraphBake
+{
+	struct FNode
+	{
+		FVector Location = FVector::ZeroVector;
+		float InteractionRadius = 0.f;
+	};
+
+	struct FSettings
+	{
+		FSPSwingStepParams StepParams;
+		float GravityZ = 0.f;
+		float TerminalVelocity = 0.f;
+		float JumpZVelocity = 0.f;
+		float ImpulseRatio = 1.f;
+		float EntryRopeLengthRatio = 1.f;
+		float EntryRopeAngle = 0.f;
+		float MaxSwingTime = 0.f;
+		float MaxFlightTime = 0.f;
+		float StepTime = 0.f;
+		ECollisionChannel CollisionChannel = ECC_Pawn;
+		FCollisionShape CollisionShape;
+		FCollisionQueryParams QueryParams;
+	};
+
+	static bool IsSegmentClear(const UWorld* World, const FSettings& Settings, const FVector& Start, const FVector& End)
+	{
+		return !World->SweepTestByChannel(Start, End, FQuat::Identity, Settings.CollisionChannel, Settings.CollisionShape, Settings.QueryParams);
+	}
+
+	// Falls from the release state the way the movement component does, OutFlightTime is when the target radius is entered
+	static bool FindFlightToTarget(const UWorld* World, const FSettings& Settings, const FVector& ReleaseLocation, const FVector& ReleaseVelocity,
+		const FNode& Target, float MaxTime, float& OutFlightTime)
+	{
+		const float TargetRadiusSquared = FMath::Square(Target.InteractionRadius);
+		const int32 NumSteps = FMath::CeilToInt(FMath::Min(MaxTime, Settings.MaxFlightTime) / Settings.StepTime);
+		FVector Location = ReleaseLocation;
+		FVector Velocity = ReleaseVelocity;
+		int32 ReachStep = INDEX_NONE;
+		TArray<FVector, TInlineAllocator<64>> FlightPoints;
+		FlightPoints.Add(Location);
+		for (int32 Step = 1; Step <= NumSteps; ++Step)
+		{
+			Velocity.Z += Settings.GravityZ * Settings.StepTime;
+			Velocity = Velocity.GetClampedToMaxSize(Settings.TerminalVelocity);
+			Location += Velocity * Settings.StepTime;
+			FlightPoints.Add(Location);
+			if (FVector::DistSquared(Location, Target.Location) <= TargetRadiusSquared)
+			{
+				ReachStep = Step;
+				break;
+			}
+		}
+
+		if (ReachStep == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// Only arcs that reach the target are swept
+		for (int32 Step = 1; Step < FlightPoints.Num(); ++Step)
+		{
+			if (!IsSegmentClear(World, Settings, FlightPoints[Step - 1], FlightPoints[Step]))
+			{
+				return false;
+			}
+		}
+
+		OutFlightTime = ReachStep * Settings.StepTime;
+		return true;
+	}
+
+	static bool FindTransition(const UWorld* World, const FSettings& Settings, const FNode& Source, const FNode& Target, float& OutCost, float& OutReleaseTime)
+	{
+		const FVector Forward = FVector(Target.Location.X - Source.Location.X, Target.Location.Y - Source.Location.Y, 0.f).GetSafeNormal();
+		if (Forward.IsZero())
+		{
+			return false;
+		}
+
+		// The character throws the rope while falling back to the height it jumped from, on the far side of the anchor
+		FSPSwingState State;
+		State.AnchorLocation = Source.Location;
+		State.RopeLength = Source.InteractionRadius * Settings.EntryRopeLengthRatio;
+		State.Location = Source.Location + (-Forward * FMath::Sin(Settings.EntryRopeAngle) - FVector::UpVector * FMath::Cos(Settings.EntryRopeAngle)) * State.RopeLength;
+		State.Velocity = FVector(0.f, 0.f, -Settings.JumpZVelocity);
+		State.Acceleration = FVector(0.f, 0.f, Settings.GravityZ);
+		State.ImpulseRatio = Settings.ImpulseRatio;
+
+		OutCost = MAX_flt;
+		const int32 NumSwingSteps = FMath::CeilToInt(Settings.MaxSwingTime / Settings.StepTime);
+		for (int32 Step = 1; Step <= NumSwingSteps; ++Step)
+		{
+			const FVector PreviousLocation = State.Location;
+			FSPSwingKernel::StepState(State, Settings.StepTime, Settings.StepParams);
+			if (!IsSegmentClear(World, Settings, PreviousLocation, State.Location))
+			{
+				break;
+			}
+
+			const float ReleaseTime = Step * Settings.StepTime;
+			if (ReleaseTime >= OutCost)
+			{
+				break;
+			}
+
+			float FlightTime = 0.f;
+			if (FindFlightToTarget(World, Settings, State.Location, State.Velocity, Target, OutCost - ReleaseTime, FlightTime))
+			{
+				OutCost = ReleaseTime + FlightTime;
+				OutReleaseTime = ReleaseTime;
+			}
+		}
+		return OutCost < MAX_flt;
+	}
+}
+
+void ASPSwingGraphActor::BakeGraph()
+{
+	using namespace SPSwingGraphBake;
+
+	UWorld* World = GetWorld();
+	if (!IsValid(Graph) || !IsValid(World) || World->IsGameWorld())
+	{
+		UE_LOG(LogSwingGraph, Warning, TEXT("%s: swing graphs are baked into a graph asset from an editor world"), *GetName());
+		return;
+	}
+
+	const ASwingProjCharacter* CharacterDefaults = IsValid(CharacterClass) ? CharacterClass->GetDefaultObject<ASwingProjCharacter>() : GetDefault<ASwingProjCharacter>();
+	const USPBaseCharacterMovementComponent* MovementDefaults = CharacterDefaults->GetBaseCharacterMovementComponent();
+
+	FSettings Settings;
+	Settings.StepParams = MovementDefaults->GetSwingStepParams();
+	Settings.GravityZ = World->GetGravityZ();
+	Settings.TerminalVelocity = GetDefault<APhysicsVolume>()->TerminalVelocity;
+	Settings.JumpZVelocity = MovementDefaults->JumpZVelocity;
+	Settings.ImpulseRatio = FMath::Clamp(CharacterDefaults->GetRopeImpulseRatio(), 1.f, 2.f);
+	Settings.EntryRopeLengthRatio = EntryRopeLengthRatio;
+	Settings.EntryRopeAngle = FMath::DegreesToRadians(EntryRopeAngle);
+	Settings.MaxSwingTime = MaxSwingTime;
+	Settings.MaxFlightTime = MaxFlightTime;
+	Settings.StepTime = SimulationStepTime;
+	Settings.CollisionChannel = CollisionChannel;
+	Settings.CollisionShape = CharacterDefaults->GetCapsuleComponent()->GetCollisionShape();
+	Settings.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(SwingGraphBake), false);
+
+	TArray<FNode> Nodes;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		if (const ARopeSwingAttachmentActor* Anchor = Cast<ARopeSwingAttachmentActor>(*It))
+		{
+			Nodes.Add({ Anchor->GetActorLocation(), Anchor->GetInteractionRadius() });
+			Settings.QueryParams.AddIgnoredActor(Anchor);
+		}
+		else if (const ASPAnchorDataActor* DataActor = Cast<ASPAnchorDataActor>(*It))
+		{
+			if (IsValid(DataActor->GetAnchorClass()) && DataActor->GetAnchorClass()->IsChildOf<ARopeSwingAttachmentActor>())
+			{
+				for (int32 RecordIndex = 0; RecordIndex < DataActor->GetNumRecords(); ++RecordIndex)
+				{
+					Nodes.Add({ DataActor->GetRecordTransform(RecordIndex).GetLocation(), DataActor->GetRecord(RecordIndex).InteractionRadius });
+				}
+			}
+		}
+	}
+
+	Graph->Modify();
+	Graph->NodeLocations.Reset(Nodes.Num());
+	Graph->EdgeOffsets.Reset(Nodes.Num() + 1);
+	Graph->EdgeTargets.Reset();
+	Graph->EdgeCosts.Reset();
+	Graph->EdgeReleaseTimes.Reset();
+	Graph->MaxEdgeSpeed = 0.f;
+
+	const float MaxEdgeDistanceSquared = FMath::Square(MaxEdgeDistance);
+	for (int32 Source = 0; Source < Nodes.Num(); ++Source)
+	{
+		Graph->NodeLocations.Add(Nodes[Source].Location);
+		Graph->EdgeOffsets.Add(Graph->EdgeTargets.Num());
+		for (int32 Target = 0; Target < Nodes.Num(); ++Target)
+		{
+			const float DistanceSquared = FVector::DistSquared(Nodes[Source].Location, Nodes[Target].Location);
+			if (Target == Source || DistanceSquared > MaxEdgeDistanceSquared)
+			{
+				continue;
+			}
+
+			float Cost = 0.f;
+			float ReleaseTime = 0.f;
+			if (FindTransition(World, Settings, Nodes[Source], Nodes[Target], Cost, ReleaseTime))
+			{
+				Graph->EdgeTargets.Add(Target);
+				Graph->EdgeCosts.Add(Cost);
+				Graph->EdgeReleaseTimes.Add(ReleaseTime);
+				Graph->MaxEdgeSpeed = FMath::Max(Graph->MaxEdgeSpeed, FMath::Sqrt(DistanceSquared) / FMath::Max(Cost, KINDA_SMALL_NUMBER));
+			}
+		}
+	}
+	Graph->EdgeOffsets.Add(Graph->EdgeTargets.Num());
+
+	UE_LOG(LogSwingGraph, Display, TEXT("%s: baked %d anchors and %d swing transitions into %s"), *GetName(), Graph->GetNumNodes(), Graph->GetNumEdges(), *Graph->GetPathName());
+}
+#endif
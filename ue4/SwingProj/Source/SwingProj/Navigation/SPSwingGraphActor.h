@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SPSwingGraphActor.generated.h"
+
+class ASwingProjCharacter;
+class USPSwingGraph;
+
+/**
+ * Holds the swing graph of its level and bakes it in the editor.
+ * Every rope swing anchor of the level, placed or authored as data, becomes a node. An edge is baked when a swing on
+ * one anchor followed by a release reaches the interaction radius of the other without hitting the level.
+ */
+UCLASS(HideCategories = (Rendering, Replication, Input, Actor, LOD, Cooking))
+class SWINGPROJ_API ASPSwingGraphActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASPSwingGraphActor();
+
+	USPSwingGraph* GetGraph() const { return Graph; }
+
+#if WITH_EDITOR
+	UFUNCTION(CallInEditor, Category = "Swing Graph")
+	void BakeGraph();
+#endif
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Swing Graph")
+	USPSwingGraph* Graph;
+
+	// Swing and jump settings are read from the defaults of this class
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake")
+	TSubclassOf<ASwingProjCharacter> CharacterClass;
+
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake", meta = (ClampMin = "0", UIMin = "0"))
+	float MaxEdgeDistance = 3000.f;
+
+	// Rope length a character enters a swing with, relative to the interaction radius of the anchor
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake", meta = (ClampMin = "0.1", UIMin = "0.1", ClampMax = "1", UIMax = "1"))
+	float EntryRopeLengthRatio = 0.9f;
+
+	// Angle between the rope and the vertical when the character enters a swing, on the side away from the next anchor
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake", meta = (ClampMin = "0", UIMin = "0", ClampMax = "90", UIMax = "90"))
+	float EntryRopeAngle = 45.f;
+
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake", meta = (ClampMin = "0.1", UIMin = "0.1"))
+	float MaxSwingTime = 3.f;
+
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake", meta = (ClampMin = "0.1", UIMin = "0.1"))
+	float MaxFlightTime = 2.f;
+
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake", meta = (ClampMin = "0.005", UIMin = "0.005", ClampMax = "0.1", UIMax = "0.1"))
+	float SimulationStepTime = 1.f / 30.f;
+
+	UPROPERTY(EditAnywhere, Category = "Swing Graph Bake")
+	TEnumAsByte<ECollisionChannel> CollisionChannel = ECC_Pawn;
+};
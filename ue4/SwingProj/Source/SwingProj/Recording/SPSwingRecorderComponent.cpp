@@ -0,0 +1,300 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingRecorderComponent.h"
+
+#include "Actors/Interactive/RopeSwingAttachmentActor.h"
+#include "Characters/SwingProjCharacter.h"
+#include "Components/InputComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSwingRecording, Log, All);
+
+USPSwingRecorderComponent::USPSwingRecorderComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	// Records the input of a frame together with the swing state it ended in
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void USPSwingRecorderComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	SwingCharacter = Cast<ASwingProjCharacter>(GetOwner());
+}
+
+void USPSwingRecorderComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopRecording();
+	Reader.Close();
+	bIsPlayingBack = false;
+	Super::EndPlay(EndPlayReason);
+}
+
+void USPSwingRecorderComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!IsValid(SwingCharacter))
+	{
+		return;
+	}
+
+	if (!bHasCheckedCommandLine)
+	{
+		CheckCommandLine();
+		return;
+	}
+
+	if (IsRecording())
+	{
+		RecordFrame(DeltaTime);
+	}
+	else if (bIsPlayingBack)
+	{
+		PlaybackFrame();
+	}
+}
+
+void USPSwingRecorderComponent::CheckCommandLine()
+{
+	// Only the local player's character is recorded, wait until it is possessed
+	if (SwingCharacter->GetLocalRole() != ROLE_SimulatedProxy && SwingCharacter->GetController() == nullptr)
+	{
+		return;
+	}
+	bHasCheckedCommandLine = true;
+
+	if (!SwingCharacter->IsLocallyControlled() || !SwingCharacter->IsPlayerControlled())
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	FString FilePath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("SwingRecord="), FilePath))
+	{
+		StartRecording(FilePath);
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("SwingReplay="), FilePath))
+	{
+		StartPlayback(FilePath);
+	}
+	else
+	{
+		SetComponentTickEnabled(false);
+	}
+}
+
+bool USPSwingRecorderComponent::StartRecording(const FString& FilePath)
+{
+	if (!IsValid(SwingCharacter) || bIsPlayingBack)
+	{
+		return false;
+	}
+
+	FSPSwingRecordingHeader Header;
+	Header.MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	Header.StartLocation = SwingCharacter->GetActorLocation();
+	Header.StartRotation = SwingCharacter->GetActorRotation();
+	Header.StartVelocity = SwingCharacter->GetVelocity();
+
+	if (!Writer.Open(FilePath, Header, RecordingBufferSize))
+	{
+		UE_LOG(LogSwingRecording, Error, TEXT("Can't open %s for recording"), *FilePath);
+		return false;
+	}
+
+	PendingEvents = ESPSwingRecordEvent::None;
+	SetTickGroup(TG_PostPhysics);
+	SetComponentTickEnabled(true);
+	UE_LOG(LogSwingRecording, Display, TEXT("Recording swing session to %s"), *FilePath);
+	return true;
+}
+
+void USPSwingRecorderComponent::StopRecording()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	const int32 NumFrames = Writer.GetNumFrames();
+	Writer.Close();
+	UE_LOG(LogSwingRecording, Display, TEXT("Swing recording finished: %d frames, %lld bytes"), NumFrames, Writer.GetNumBytesWritten());
+}
+
+void USPSwingRecorderComponent::CaptureFrame(FSPSwingRecordFrame& OutFrame) const
+{
+	OutFrame.RopeVector = SwingCharacter->GetCurrentRopeVector();
+	OutFrame.bIsRopeStretched = SwingCharacter->GetBaseCharacterMovementComponent()->IsRopeStretched();
+	const ARopeSwingAttachmentActor* Anchor = SwingCharacter->GetCurrentRopeSwingAttachActor();
+	OutFrame.AnchorId = IsValid(Anchor) ? Anchor->GetStableId() : 0;
+}
+
+void USPSwingRecorderComponent::RecordFrame(float DeltaTime)
+{
+	FSPSwingRecordFrame Frame;
+	Frame.DeltaTime = DeltaTime;
+	Frame.ControlRotation = SwingCharacter->GetControlRotation();
+	Frame.Events = PendingEvents;
+	PendingEvents = ESPSwingRecordEvent::None;
+
+	const UInputComponent* Input = SwingCharacter->InputComponent;
+	if (IsValid(Input))
+	{
+		Frame.MoveForward = Input->GetAxisValue(FName(TEXT("MoveForward")));
+		Frame.MoveRight = Input->GetAxisValue(FName(TEXT("MoveRight")));
+	}
+
+	CaptureFrame(Frame);
+	Writer.WriteFrame(Frame);
+}
+
+bool USPSwingRecorderComponent::StartPlayback(const FString& FilePath)
+{
+	if (!IsValid(SwingCharacter) || IsRecording())
+	{
+		return false;
+	}
+
+	if (!Reader.Open(FilePath) || !Reader.ReadFrame(NextPlaybackFrame))
+	{
+		UE_LOG(LogSwingRecording, Error, TEXT("Can't read swing recording %s"), *FilePath);
+		Reader.Close();
+		return false;
+	}
+
+	const FSPSwingRecordingHeader& Header = Reader.GetHeader();
+	if (Header.MapName != UWorld::RemovePIEPrefix(GetWorld()->GetMapName()))
+	{
+		UE_LOG(LogSwingRecording, Warning, TEXT("Swing recording %s was made on %s, the replay is not going to match"), *FilePath, *Header.MapName);
+	}
+
+	SwingCharacter->DisableInput(Cast<APlayerController>(SwingCharacter->GetController()));
+	SwingCharacter->SetActorLocationAndRotation(Header.StartLocation, Header.StartRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	SwingCharacter->GetCharacterMovement()->Velocity = Header.StartVelocity;
+
+	// Frames have to run at their recorded length, and input has to be applied before the character moves
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(NextPlaybackFrame.DeltaTime);
+	SetTickGroup(TG_PrePhysics);
+	SwingCharacter->GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, PrimaryComponentTick);
+	SetComponentTickEnabled(true);
+
+	bIsPlayingBack = true;
+	bHasNextPlaybackFrame = true;
+	bHasPreviousPlaybackFrame = false;
+	NumPlaybackFrames = 0;
+	NumDivergedFrames = 0;
+	FirstDivergedFrame = INDEX_NONE;
+	MaxRopeVectorError = 0.f;
+	PlaybackStartTime = FPlatformTime::Seconds();
+	UE_LOG(LogSwingRecording, Display, TEXT("Replaying swing session %s"), *FilePath);
+	return true;
+}
+
+void USPSwingRecorderComponent::PlaybackFrame()
+{
+	if (bHasPreviousPlaybackFrame)
+	{
+		CompareWithRecording(PreviousPlaybackFrame);
+
+		// The hook attached after the character moved, which is the same as before it moves in the next frame
+		if (EnumHasAnyFlags(PreviousPlaybackFrame.Events, ESPSwingRecordEvent::AttachToRope))
+		{
+			SwingCharacter->AttachToRope();
+		}
+	}
+
+	// The state of the last frame is only known once it has been simulated
+	if (!bHasNextPlaybackFrame)
+	{
+		FinishPlayback();
+		return;
+	}
+
+	const FSPSwingRecordFrame& Frame = NextPlaybackFrame;
+	AController* Controller = SwingCharacter->GetController();
+	if (IsValid(Controller))
+	{
+		Controller->SetControlRotation(Frame.ControlRotation);
+	}
+
+	if (EnumHasAnyFlags(Frame.Events, ESPSwingRecordEvent::ThrowRope))
+	{
+		SwingCharacter->ThrowRope();
+	}
+	if (EnumHasAnyFlags(Frame.Events, ESPSwingRecordEvent::Jump))
+	{
+		SwingCharacter->Jump();
+	}
+	if (EnumHasAnyFlags(Frame.Events, ESPSwingRecordEvent::StopJumping))
+	{
+		SwingCharacter->StopJumping();
+	}
+	SwingCharacter->MoveForward(Frame.MoveForward);
+	SwingCharacter->MoveRight(Frame.MoveRight);
+
+	PreviousPlaybackFrame = Frame;
+	bHasPreviousPlaybackFrame = true;
+
+	bHasNextPlaybackFrame = Reader.ReadFrame(NextPlaybackFrame);
+	if (bHasNextPlaybackFrame)
+	{
+		FApp::SetFixedDeltaTime(NextPlaybackFrame.DeltaTime);
+	}
+	else
+	{
+		Reader.Close();
+	}
+}
+
+void USPSwingRecorderComponent::CompareWithRecording(const FSPSwingRecordFrame& RecordedFrame)
+{
+	FSPSwingRecordFrame ReplayedFrame;
+	CaptureFrame(ReplayedFrame);
+
+	const float RopeVectorError = FVector::Dist(ReplayedFrame.RopeVector, RecordedFrame.RopeVector);
+	MaxRopeVectorError = FMath::Max(MaxRopeVectorError, RopeVectorError);
+
+	const bool bHasDiverged = RopeVectorError > PlaybackTolerance
+		|| ReplayedFrame.bIsRopeStretched != RecordedFrame.bIsRopeStretched
+		|| ReplayedFrame.AnchorId != RecordedFrame.AnchorId;
+	if (bHasDiverged)
+	{
+		NumDivergedFrames++;
+		if (FirstDivergedFrame == INDEX_NONE)
+		{
+			FirstDivergedFrame = NumPlaybackFrames;
+		}
+	}
+	NumPlaybackFrames++;
+}
+
+void USPSwingRecorderComponent::FinishPlayback()
+{
+	const double PlaybackTime = FPlatformTime::Seconds() - PlaybackStartTime;
+	UE_LOG(LogSwingRecording, Display, TEXT("Swing replay finished: %d frames in %.2f s, %.3f ms/frame"), NumPlaybackFrames, PlaybackTime, NumPlaybackFrames > 0 ? PlaybackTime * 1000.0 / NumPlaybackFrames : 0.0);
+	if (NumDivergedFrames > 0)
+	{
+		UE_LOG(LogSwingRecording, Warning, TEXT("Swing replay diverged in %d frames, first at frame %d, max rope vector error %.2f"), NumDivergedFrames, FirstDivergedFrame, MaxRopeVectorError);
+	}
+	else
+	{
+		UE_LOG(LogSwingRecording, Display, TEXT("Swing replay matched the recording, max rope vector error %.2f"), MaxRopeVectorError);
+	}
+
+	bIsPlayingBack = false;
+	FApp::SetUseFixedTimeStep(false);
+	SwingCharacter->EnableInput(Cast<APlayerController>(SwingCharacter->GetController()));
+	SetComponentTickEnabled(false);
+
+	if (!GIsEditor)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SPSwingRecording.h"
+#include "SPSwingRecorderComponent.generated.h"
+
+class ASwingProjCharacter;
+
+/**
+ * Records a player's swing session to a file or drives the character from one.
+ * Started with -SwingRecord=<file> or -SwingReplay=<file>, a replay runs at the recorded frame times and reports where the swing state diverged.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SWINGPROJ_API USPSwingRecorderComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USPSwingRecorderComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	UFUNCTION(BlueprintCallable, Category = "Swing Recording")
+	bool StartRecording(const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category = "Swing Recording")
+	void StopRecording();
+
+	UFUNCTION(BlueprintCallable, Category = "Swing Recording")
+	bool StartPlayback(const FString& FilePath);
+
+	UFUNCTION(BlueprintPure, Category = "Swing Recording")
+	bool IsRecording() const { return Writer.IsOpen(); }
+
+	UFUNCTION(BlueprintPure, Category = "Swing Recording")
+	bool IsPlayingBack() const { return bIsPlayingBack; }
+
+	// Called by the character for every gameplay event that has to be reproduced
+	void RecordEvent(ESPSwingRecordEvent Event)
+	{
+		if (IsRecording())
+		{
+			PendingEvents |= Event;
+		}
+	}
+
+protected:
+	// Size of each of the two encode buffers, a full one is written to disk off the game thread
+	UPROPERTY(EditDefaultsOnly, Category = "Swing Recording", meta = (ClampMin = "1024", UIMin = "1024"))
+	int32 RecordingBufferSize = 256 * 1024;
+
+	// Rope vector error above which a replayed frame counts as diverged
+	UPROPERTY(EditDefaultsOnly, Category = "Swing Recording", meta = (ClampMin = "0", UIMin = "0"))
+	float PlaybackTolerance = 5.f;
+
+private:
+	void CheckCommandLine();
+	void CaptureFrame(FSPSwingRecordFrame& OutFrame) const;
+	void RecordFrame(float DeltaTime);
+	void PlaybackFrame();
+	void CompareWithRecording(const FSPSwingRecordFrame& RecordedFrame);
+	void FinishPlayback();
+
+	UPROPERTY(Transient)
+	ASwingProjCharacter* SwingCharacter;
+
+	FSPSwingRecordWriter Writer;
+	FSPSwingRecordReader Reader;
+	ESPSwingRecordEvent PendingEvents = ESPSwingRecordEvent::None;
+	bool bHasCheckedCommandLine = false;
+
+	bool bIsPlayingBack = false;
+	bool bHasNextPlaybackFrame = false;
+	bool bHasPreviousPlaybackFrame = false;
+	// Read one frame ahead, the engine has to know the next frame time before that frame starts
+	FSPSwingRecordFrame NextPlaybackFrame;
+	FSPSwingRecordFrame PreviousPlaybackFrame;
+	int32 NumPlaybackFrames = 0;
+	int32 NumDivergedFrames = 0;
+	int32 FirstDivergedFrame = INDEX_NONE;
+	float MaxRopeVectorError = 0.f;
+	double PlaybackStartTime = 0.0;
+};
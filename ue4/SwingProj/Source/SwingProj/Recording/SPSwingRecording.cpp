@@ -0,0 +1,345 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingRecording.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Crc.h"
+
+namespace SPSwingRecording
+{
+	static constexpr float TimeQuantization = 1000000.f;
+	static constexpr float AxisQuantization = 127.f;
+	static constexpr float LocationQuantization = 10.f;
+	static constexpr uint32 RopeStretchedFlag = 1 << 7;
+
+	void WriteVarint(uint32 Value, TArray<uint8>& OutBytes)
+	{
+		while (Value >= 0x80)
+		{
+			OutBytes.Add((uint8)(Value | 0x80));
+			Value >>= 7;
+		}
+		OutBytes.Add((uint8)Value);
+	}
+
+	bool ReadVarint(FArchive& Ar, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Shift = 0; Shift < 35; Shift += 7)
+		{
+			uint8 Byte = 0;
+			Ar.Serialize(&Byte, 1);
+			if (Ar.IsError())
+			{
+				return false;
+			}
+
+			OutValue |= (uint32)(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint32 ZigZag(int32 Value)
+	{
+		return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+	}
+
+	int32 UnZigZag(uint32 Value)
+	{
+		return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+	}
+}
+
+bool FSPSwingRecordingHeader::Serialize(FArchive& Ar)
+{
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	Ar << FileMagic << FileVersion;
+	if (FileMagic != Magic || FileVersion != Version)
+	{
+		return false;
+	}
+
+	Ar << MapName << StartLocation << StartRotation << StartVelocity;
+	return !Ar.IsError();
+}
+
+uint32 FSPSwingRecordFrame::GetAnchorId(const AActor* Anchor)
+{
+	// Actor paths are the same in every process that loads the map, unlike name table indices, object indices or spatial handles
+	return IsValid(Anchor) ? FCrc::StrCrc32(*UWorld::RemovePIEPrefix(Anchor->GetPathName())) | 1 : 0;
+}
+
+void FSPSwingRecordCodec::Reset()
+{
+	FMemory::Memzero(PreviousValues);
+}
+
+void FSPSwingRecordCodec::Quantize(const FSPSwingRecordFrame& Frame, uint32* OutValues)
+{
+	using namespace SPSwingRecording;
+	OutValues[DeltaTime] = (uint32)FMath::RoundToInt(Frame.DeltaTime * TimeQuantization);
+	OutValues[MoveForward] = (uint32)FMath::RoundToInt(FMath::Clamp(Frame.MoveForward, -1.f, 1.f) * AxisQuantization);
+	OutValues[MoveRight] = (uint32)FMath::RoundToInt(FMath::Clamp(Frame.MoveRight, -1.f, 1.f) * AxisQuantization);
+	OutValues[Pitch] = FRotator::CompressAxisToShort(Frame.ControlRotation.Pitch);
+	OutValues[Yaw] = FRotator::CompressAxisToShort(Frame.ControlRotation.Yaw);
+	OutValues[Flags] = (uint32)Frame.Events | (Frame.bIsRopeStretched ? RopeStretchedFlag : 0);
+	OutValues[RopeX] = (uint32)FMath::RoundToInt(Frame.RopeVector.X * LocationQuantization);
+	OutValues[RopeY] = (uint32)FMath::RoundToInt(Frame.RopeVector.Y * LocationQuantization);
+	OutValues[RopeZ] = (uint32)FMath::RoundToInt(Frame.RopeVector.Z * LocationQuantization);
+	OutValues[AnchorId] = Frame.AnchorId;
+}
+
+void FSPSwingRecordCodec::Dequantize(const uint32* Values, FSPSwingRecordFrame& OutFrame)
+{
+	using namespace SPSwingRecording;
+	OutFrame.DeltaTime = Values[DeltaTime] / TimeQuantization;
+	OutFrame.MoveForward = (int32)Values[MoveForward] / AxisQuantization;
+	OutFrame.MoveRight = (int32)Values[MoveRight] / AxisQuantization;
+	OutFrame.ControlRotation = FRotator(FRotator::DecompressAxisFromShort((uint16)Values[Pitch]), FRotator::DecompressAxisFromShort((uint16)Values[Yaw]), 0.f);
+	OutFrame.Events = (ESPSwingRecordEvent)(Values[Flags] & ~RopeStretchedFlag);
+	OutFrame.bIsRopeStretched = (Values[Flags] & RopeStretchedFlag) != 0;
+	OutFrame.RopeVector = FVector((int32)Values[RopeX], (int32)Values[RopeY], (int32)Values[RopeZ]) / LocationQuantization;
+	OutFrame.AnchorId = Values[AnchorId];
+}
+
+void FSPSwingRecordCodec::EncodeFrame(const FSPSwingRecordFrame& Frame, TArray<uint8>& OutBytes)
+{
+	uint32 Values[NumFields];
+	Quantize(Frame, Values);
+
+	uint32 ChangeMask = 0;
+	for (int32 Field = 0; Field < NumFields; ++Field)
+	{
+		if (Values[Field] != PreviousValues[Field])
+		{
+			ChangeMask |= 1 << Field;
+		}
+	}
+
+	SPSwingRecording::WriteVarint(ChangeMask, OutBytes);
+	for (int32 Field = 0; Field < NumFields; ++Field)
+	{
+		if (ChangeMask & (1 << Field))
+		{
+			SPSwingRecording::WriteVarint(SPSwingRecording::ZigZag((int32)(Values[Field] - PreviousValues[Field])), OutBytes);
+			PreviousValues[Field] = Values[Field];
+		}
+	}
+}
+
+bool FSPSwingRecordCodec::DecodeFrame(FArchive& Ar, FSPSwingRecordFrame& OutFrame)
+{
+	if (Ar.AtEnd())
+	{
+		return false;
+	}
+
+	uint32 ChangeMask = 0;
+	if (!SPSwingRecording::ReadVarint(Ar, ChangeMask))
+	{
+		return false;
+	}
+
+	for (int32 Field = 0; Field < NumFields; ++Field)
+	{
+		if (ChangeMask & (1 << Field))
+		{
+			uint32 EncodedDelta = 0;
+			if (!SPSwingRecording::ReadVarint(Ar, EncodedDelta))
+			{
+				return false;
+			}
+			PreviousValues[Field] += (uint32)SPSwingRecording::UnZigZag(EncodedDelta);
+		}
+	}
+
+	Dequantize(PreviousValues, OutFrame);
+	return true;
+}
+
+class FSPSwingRecordFileWriter : public FRunnable
+{
+public:
+	explicit FSPSwingRecordFileWriter(FArchive* InFileArchive)
+		: FileArchive(InFileArchive)
+		, WorkEvent(FPlatformProcess::GetSynchEventFromPool(false))
+		, IdleEvent(FPlatformProcess::GetSynchEventFromPool(true))
+	{
+		IdleEvent->Trigger();
+	}
+
+	virtual ~FSPSwingRecordFileWriter() override
+	{
+		FileArchive->Close();
+		delete FileArchive;
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		FPlatformProcess::ReturnSynchEventToPool(IdleEvent);
+	}
+
+	// Game thread. Waits for the previous buffer to be written, so the caller can reuse it once this returns
+	void WriteBuffer(TArray<uint8>& Buffer)
+	{
+		IdleEvent->Wait();
+		IdleEvent->Reset();
+		PendingBuffer = &Buffer;
+		WorkEvent->Trigger();
+	}
+
+	virtual uint32 Run() override
+	{
+		while (!bStopping)
+		{
+			WorkEvent->Wait();
+			WritePendingBuffer();
+		}
+
+		// A buffer handed over together with the stop request
+		WritePendingBuffer();
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+		WorkEvent->Trigger();
+	}
+
+private:
+	void WritePendingBuffer()
+	{
+		TArray<uint8>* Buffer = PendingBuffer.Exchange(nullptr);
+		if (Buffer != nullptr)
+		{
+			FileArchive->Serialize(Buffer->GetData(), Buffer->Num());
+			// Reset keeps the allocation for the next round
+			Buffer->Reset();
+			IdleEvent->Trigger();
+		}
+	}
+
+	FArchive* FileArchive;
+	FEvent* WorkEvent;
+	FEvent* IdleEvent;
+	TAtomic<TArray<uint8>*> PendingBuffer { nullptr };
+	TAtomic<bool> bStopping { false };
+};
+
+FSPSwingRecordWriter::~FSPSwingRecordWriter()
+{
+	Close();
+}
+
+bool FSPSwingRecordWriter::Open(const FString& FilePath, const FSPSwingRecordingHeader& Header, int32 InBufferSize)
+{
+	Close();
+
+	FArchive* FileArchive = IFileManager::Get().CreateFileWriter(*FilePath);
+	if (FileArchive == nullptr)
+	{
+		return false;
+	}
+
+	FSPSwingRecordingHeader WrittenHeader = Header;
+	WrittenHeader.Serialize(*FileArchive);
+	NumBytesWritten = FileArchive->Tell();
+
+	BufferSize = FMath::Max(InBufferSize, FSPSwingRecordCodec::MaxFrameSize * 2);
+	Buffers[0].Empty(BufferSize);
+	Buffers[1].Empty(BufferSize);
+	ActiveBuffer = 0;
+	Codec.Reset();
+	NumFrames = 0;
+
+	FileWriter = MakeUnique<FSPSwingRecordFileWriter>(FileArchive);
+	FileWriterThread = FRunnableThread::Create(FileWriter.Get(), TEXT("SwingRecordWriter"), 0, TPri_BelowNormal);
+	return true;
+}
+
+void FSPSwingRecordWriter::WriteFrame(const FSPSwingRecordFrame& Frame)
+{
+	if (!IsOpen())
+	{
+		return;
+	}
+
+	if (Buffers[ActiveBuffer].Num() + FSPSwingRecordCodec::MaxFrameSize > BufferSize)
+	{
+		FlushActiveBuffer();
+	}
+
+	Codec.EncodeFrame(Frame, Buffers[ActiveBuffer]);
+	NumFrames++;
+}
+
+void FSPSwingRecordWriter::FlushActiveBuffer()
+{
+	NumBytesWritten += Buffers[ActiveBuffer].Num();
+	FileWriter->WriteBuffer(Buffers[ActiveBuffer]);
+	ActiveBuffer ^= 1;
+}
+
+void FSPSwingRecordWriter::Close()
+{
+	if (!IsOpen())
+	{
+		return;
+	}
+
+	if (Buffers[ActiveBuffer].Num() > 0)
+	{
+		FlushActiveBuffer();
+	}
+
+	FileWriterThread->Kill(true);
+	delete FileWriterThread;
+	FileWriterThread = nullptr;
+	FileWriter.Reset();
+
+	Buffers[0].Empty();
+	Buffers[1].Empty();
+}
+
+bool FSPSwingRecordReader::Open(const FString& FilePath)
+{
+	Close();
+
+	FileReader.Reset(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!FileReader.IsValid())
+	{
+		return false;
+	}
+
+	if (!Header.Serialize(*FileReader))
+	{
+		Close();
+		return false;
+	}
+
+	Codec.Reset();
+	return true;
+}
+
+bool FSPSwingRecordReader::ReadFrame(FSPSwingRecordFrame& OutFrame)
+{
+	return IsOpen() && Codec.DecodeFrame(*FileReader, OutFrame);
+}
+
+void FSPSwingRecordReader::Close()
+{
+	if (IsOpen())
+	{
+		FileReader->Close();
+		FileReader.Reset();
+	}
+}
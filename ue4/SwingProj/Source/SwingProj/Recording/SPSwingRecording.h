@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ESPSwingRecordEvent : uint8
+{
+	None = 0,
+	ThrowRope = 1 << 0,
+	AttachToRope = 1 << 1,
+	Jump = 1 << 2,
+	StopJumping = 1 << 3
+};
+ENUM_CLASS_FLAGS(ESPSwingRecordEvent);
+
+struct FSPSwingRecordingHeader
+{
+	static constexpr uint32 Magic = 0x52535053;
+	static constexpr uint32 Version = 2;
+
+	FString MapName;
+	FVector StartLocation = FVector::ZeroVector;
+	FRotator StartRotation = FRotator::ZeroRotator;
+	FVector StartVelocity = FVector::ZeroVector;
+
+	// False when loading a file that is not a swing recording
+	bool Serialize(FArchive& Ar);
+};
+
+/** One frame of a swing session: the input that was applied and the swing state it ended in */
+struct FSPSwingRecordFrame
+{
+	float DeltaTime = 0.f;
+	float MoveForward = 0.f;
+	float MoveRight = 0.f;
+	FRotator ControlRotation = FRotator::ZeroRotator;
+	ESPSwingRecordEvent Events = ESPSwingRecordEvent::None;
+
+	FVector RopeVector = FVector::ZeroVector;
+	bool bIsRopeStretched = false;
+	uint32 AnchorId = 0;
+
+	static uint32 GetAnchorId(const AActor* Anchor);
+};
+
+/**
+ * Frames quantized to integers, every field stored as a zigzag varint of its change since the previous frame.
+ * A frame that repeats the previous one costs a single byte.
+ */
+class FSPSwingRecordCodec
+{
+public:
+	// Longest possible encoded frame
+	static constexpr int32 MaxFrameSize = 2 + 10 * 5;
+
+	void Reset();
+
+	void EncodeFrame(const FSPSwingRecordFrame& Frame, TArray<uint8>& OutBytes);
+	bool DecodeFrame(FArchive& Ar, FSPSwingRecordFrame& OutFrame);
+
+private:
+	enum EField
+	{
+		DeltaTime,
+		MoveForward,
+		MoveRight,
+		Pitch,
+		Yaw,
+		Flags,
+		RopeX,
+		RopeY,
+		RopeZ,
+		AnchorId,
+		NumFields
+	};
+
+	static void Quantize(const FSPSwingRecordFrame& Frame, uint32* OutValues);
+	static void Dequantize(const uint32* Values, FSPSwingRecordFrame& OutFrame);
+
+	uint32 PreviousValues[NumFields] = {};
+};
+
+class FRunnableThread;
+class FSPSwingRecordFileWriter;
+
+/**
+ * Encodes frames into one of two fixed size buffers. A full buffer is handed to a background thread that writes it
+ * to disk while frames go into the other one, the game thread only waits if the disk falls a whole buffer behind.
+ */
+class FSPSwingRecordWriter
+{
+public:
+	~FSPSwingRecordWriter();
+
+	// Both buffers are allocated here, recording never allocates per frame
+	bool Open(const FString& FilePath, const FSPSwingRecordingHeader& Header, int32 BufferSize);
+	void WriteFrame(const FSPSwingRecordFrame& Frame);
+	void Close();
+
+	bool IsOpen() const { return FileWriter.IsValid(); }
+	int32 GetNumFrames() const { return NumFrames; }
+	int64 GetNumBytesWritten() const { return NumBytesWritten; }
+
+private:
+	void FlushActiveBuffer();
+
+	TUniquePtr<FSPSwingRecordFileWriter> FileWriter;
+	FRunnableThread* FileWriterThread = nullptr;
+	TArray<uint8> Buffers[2];
+	int32 ActiveBuffer = 0;
+	int32 BufferSize = 0;
+	FSPSwingRecordCodec Codec;
+	int32 NumFrames = 0;
+	int64 NumBytesWritten = 0;
+};
+
+/** Streams frames back from a file without loading it whole */
+class FSPSwingRecordReader
+{
+public:
+	bool Open(const FString& FilePath);
+	bool ReadFrame(FSPSwingRecordFrame& OutFrame);
+	void Close();
+
+	bool IsOpen() const { return FileReader.IsValid(); }
+	const FSPSwingRecordingHeader& GetHeader() const { return Header; }
+
+private:
+	TUniquePtr<FArchive> FileReader;
+	FSPSwingRecordingHeader Header;
+	FSPSwingRecordCodec Codec;
+};
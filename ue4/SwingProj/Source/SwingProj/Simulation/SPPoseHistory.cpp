@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPPoseHistory.h"
+
+void FSPPoseHistory::Reset()
+{
+	NextPose = 0;
+	NumPoses = 0;
+}
+
+void FSPPoseHistory::Add(float TimeStamp, const FVector& Location, const FRotator& ViewRotation)
+{
+	if (NumPoses > 0 && TimeStamp < GetNewestTimeStamp())
+	{
+		Reset();
+	}
+
+	FPose& Pose = Poses[NextPose];
+	Pose.TimeStamp = TimeStamp;
+	Pose.X = FMath::RoundToInt(Location.X);
+	Pose.Y = FMath::RoundToInt(Location.Y);
+	Pose.Z = FMath::RoundToInt(Location.Z);
+	Pose.Pitch = FRotator::CompressAxisToShort(ViewRotation.Pitch);
+	Pose.Yaw = FRotator::CompressAxisToShort(ViewRotation.Yaw);
+
+	NextPose = (NextPose + 1) % Capacity;
+	NumPoses = FMath::Min(NumPoses + 1, Capacity);
+}
+
+bool FSPPoseHistory::Sample(float TimeStamp, FVector& OutLocation, FVector& OutViewDirection) const
+{
+	if (NumPoses == 0)
+	{
+		return false;
+	}
+
+	// First pose not older than TimeStamp
+	int32 First = 0;
+	int32 Count = NumPoses;
+	while (Count > 0)
+	{
+		const int32 Step = Count / 2;
+		if (GetPose(First + Step).TimeStamp < TimeStamp)
+		{
+			First += Step + 1;
+			Count -= Step + 1;
+		}
+		else
+		{
+			Count = Step;
+		}
+	}
+
+	const FPose& After = GetPose(FMath::Min(First, NumPoses - 1));
+	const FPose& Before = GetPose(FMath::Max(First - 1, 0));
+	const float Span = After.TimeStamp - Before.TimeStamp;
+	const float Alpha = Span > 0.f ? FMath::Clamp((TimeStamp - Before.TimeStamp) / Span, 0.f, 1.f) : 1.f;
+	OutLocation = FMath::Lerp(GetLocation(Before), GetLocation(After), Alpha);
+
+	const FPose& Closer = Alpha < 0.5f ? Before : After;
+	OutViewDirection = FRotator(FRotator::DecompressAxisFromShort(Closer.Pitch), FRotator::DecompressAxisFromShort(Closer.Yaw), 0.f).Vector();
+	return true;
+}
+
+ESPSwingAttachVerdict FSPSwingAttachValidator::Validate(const FSPPoseHistory& History, const FSPSwingAttachClaim& Claim, const FSPSwingAttachValidationParams& Params, float& OutRopeLength)
+{
+	OutRopeLength = Claim.RopeLength;
+
+	// A hook that is out longer than its flight time has been dropped
+	const float FlightTime = Claim.AttachTimeStamp - Claim.ThrowTimeStamp;
+	if (FlightTime < 0.f || FlightTime > Params.MaxFlightTime + Params.FlightTimeTolerance)
+	{
+		return ESPSwingAttachVerdict::Rejected;
+	}
+
+	// Only the attach is clamped, the throw keeps its distance to it
+	const float NewestTimeStamp = History.GetNewestTimeStamp();
+	const float AttachTimeStamp = FMath::Clamp(Claim.AttachTimeStamp, NewestTimeStamp - Params.MaxRewindTime, NewestTimeStamp);
+	const float ThrowTimeStamp = AttachTimeStamp - FlightTime;
+
+	FVector ThrowLocation;
+	FVector ThrowViewDirection;
+	if (!History.Sample(ThrowTimeStamp, ThrowLocation, ThrowViewDirection))
+	{
+		return ESPSwingAttachVerdict::Rejected;
+	}
+
+	const FVector ToAnchor = Claim.AnchorLocation - ThrowLocation;
+	const float Distance = ToAnchor.Size();
+	if (Distance > FMath::Min(Claim.InteractionRadius, Params.MaxThrowDistance) + Params.LocationTolerance)
+	{
+		return ESPSwingAttachVerdict::Rejected;
+	}
+	if (Distance > KINDA_SMALL_NUMBER && FVector::DotProduct(ToAnchor / Distance, ThrowViewDirection) < Params.MinCosine - Params.CosineTolerance)
+	{
+		return ESPSwingAttachVerdict::Rejected;
+	}
+	if (Params.HookSpeed > 0.f && FlightTime + Params.FlightTimeTolerance < Distance / Params.HookSpeed)
+	{
+		return ESPSwingAttachVerdict::Rejected;
+	}
+
+	FVector AttachLocation;
+	FVector AttachViewDirection;
+	History.Sample(AttachTimeStamp, AttachLocation, AttachViewDirection);
+	const float AttachDistance = FVector::Dist(Claim.AnchorLocation, AttachLocation);
+	if (FMath::Abs(AttachDistance - Claim.RopeLength) > Params.RopeLengthTolerance)
+	{
+		OutRopeLength = AttachDistance;
+		return ESPSwingAttachVerdict::Corrected;
+	}
+	return ESPSwingAttachVerdict::Accepted;
+}
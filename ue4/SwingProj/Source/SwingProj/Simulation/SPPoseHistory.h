@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Ring of the last poses of a character stamped with the client's move time, locations quantized to centimeters and view angles to 16 bits.
+ * Fixed size, adding a pose never allocates.
+ */
+struct SWINGPROJ_API FSPPoseHistory
+{
+	// About a second of moves from a client sending 120 moves a second
+	static constexpr int32 Capacity = 128;
+
+	void Reset();
+
+	// Time stamps have to increase, an older one means the client clock was reset and starts the history over
+	void Add(float TimeStamp, const FVector& Location, const FRotator& ViewRotation);
+
+	// Location interpolated between the poses around TimeStamp, view of the closer one. Times outside the history clamp to its ends
+	bool Sample(float TimeStamp, FVector& OutLocation, FVector& OutViewDirection) const;
+
+	int32 Num() const { return NumPoses; }
+	float GetNewestTimeStamp() const { return NumPoses > 0 ? GetPose(NumPoses - 1).TimeStamp : 0.f; }
+
+private:
+	struct FPose
+	{
+		float TimeStamp;
+		int32 X;
+		int32 Y;
+		int32 Z;
+		uint16 Pitch;
+		uint16 Yaw;
+	};
+
+	// 0 is the oldest pose
+	const FPose& GetPose(int32 Index) const { return Poses[(NextPose - NumPoses + Index + Capacity) % Capacity]; }
+	static FVector GetLocation(const FPose& Pose) { return FVector(Pose.X, Pose.Y, Pose.Z); }
+
+	FPose Poses[Capacity];
+	int32 NextPose = 0;
+	int32 NumPoses = 0;
+};
+
+enum class ESPSwingAttachVerdict : uint8
+{
+	Accepted,
+	// The anchor was in reach but the claimed rope length was not, the length is replaced
+	Corrected,
+	Rejected
+};
+
+// What a client claims when it attaches, time stamps are in the client's move clock
+struct FSPSwingAttachClaim
+{
+	FVector AnchorLocation = FVector::ZeroVector;
+	float InteractionRadius = 0.f;
+	float RopeLength = 0.f;
+	float ThrowTimeStamp = 0.f;
+	float AttachTimeStamp = 0.f;
+};
+
+struct FSPSwingAttachValidationParams
+{
+	float MinCosine = 0.35f;
+	float MaxThrowDistance = 1500.f;
+	// Attaches further back than this before the newest pose are judged at that time, about the client's round trip
+	float MaxRewindTime = 0.4f;
+	// The time between throw and attach has to fit a hook flight, a hook speed of 0 skips the lower bound
+	float HookSpeed = 4000.f;
+	float MaxFlightTime = 1.f;
+	float FlightTimeTolerance = 0.1f;
+	float LocationTolerance = 50.f;
+	float CosineTolerance = 0.1f;
+	float RopeLengthTolerance = 50.f;
+};
+
+/**
+ * Checks a rope attach the way ThrowRope selected it: the anchor in reach and inside the view cone when the rope was thrown,
+ * the hook in flight as long as it takes to get there, and the rope as long as the distance to the anchor when it attached.
+ * Poses come from the history, not the current state.
+ */
+struct SWINGPROJ_API FSPSwingAttachValidator
+{
+	static ESPSwingAttachVerdict Validate(const FSPPoseHistory& History, const FSPSwingAttachClaim& Claim, const FSPSwingAttachValidationParams& Params, float& OutRopeLength);
+};
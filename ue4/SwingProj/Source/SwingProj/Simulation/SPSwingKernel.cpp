@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingKernel.h"
+
+void FSPSwingKernel::StepState(FSPSwingState& State, float DeltaTime, const FSPSwingStepParams& Params)
+{
+	// Fixed number of steps per frame keeps the cost bounded, the step length never exceeds SubStepTime unless the frame is longer than MaxSubSteps allow
+	const int32 NumSubSteps = FMath::Clamp(FMath::CeilToInt(DeltaTime / Params.SubStepTime), 1, Params.MaxSubSteps);
+	const float SubStepTime = DeltaTime / NumSubSteps;
+	const float RopeLengthSquared = FMath::Square(State.RopeLength);
+
+	FVector Location = State.Location;
+	FVector Velocity = State.Velocity;
+	bool bIsRopeStretched = State.bIsRopeStretched;
+	for (int32 i = 0; i < NumSubSteps; ++i)
+	{
+		Velocity += State.Acceleration * SubStepTime;
+		Location += Velocity * SubStepTime;
+
+		const FVector ToAnchor = State.AnchorLocation - Location;
+		const float DistanceSquared = ToAnchor.SizeSquared();
+		if (DistanceSquared <= RopeLengthSquared)
+		{
+			bIsRopeStretched = false;
+			continue;
+		}
+
+		const float Distance = FMath::Sqrt(DistanceSquared);
+		const FVector RopeDirection = ToAnchor / Distance;
+		Location += RopeDirection * (Distance - State.RopeLength);
+
+		const float RadialSpeed = FVector::DotProduct(Velocity, RopeDirection);
+		if (RadialSpeed < 0.f)
+		{
+			// A slack rope catching the swinger bounces it back, a taut one only cancels the outward motion
+			Velocity -= RopeDirection * RadialSpeed * (bIsRopeStretched ? 1.f : State.ImpulseRatio);
+		}
+		bIsRopeStretched = true;
+	}
+
+	State.Location = Location;
+	State.Velocity = Velocity.GetClampedToMaxSize(Params.MaxSpeed);
+	State.bIsRopeStretched = bIsRopeStretched;
+}
+
+void FSPSwingKernel::StepStates(TArrayView<FSPSwingState> States, float DeltaTime, const FSPSwingStepParams& Params)
+{
+	for (FSPSwingState& State : States)
+	{
+		StepState(State, DeltaTime, Params);
+	}
+}
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Everything one step of a rope swing reads and writes, no engine objects involved */
+struct FSPSwingState
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	FVector AnchorLocation = FVector::ZeroVector;
+	// Gravity plus whatever input acceleration applies during the step
+	FVector Acceleration = FVector::ZeroVector;
+	float RopeLength = 0.f;
+	// Share of the outward velocity bounced back when a slack rope catches the swinger, 1 only cancels it
+	float ImpulseRatio = 1.f;
+	bool bIsRopeStretched = false;
+};
+
+struct FSPSwingStepParams
+{
+	float SubStepTime = 1.f / 120.f;
+	int32 MaxSubSteps = 8;
+	float MaxSpeed = 2500.f;
+};
+
+/**
+ * Rope swing integration without collision: semi-implicit Euler sub steps, each projected back onto the rope sphere
+ */
+struct SWINGPROJ_API FSPSwingKernel
+{
+	static void StepState(FSPSwingState& State, float DeltaTime, const FSPSwingStepParams& Params);
+
+	// Steps every state in one pass over the array
+	static void StepStates(TArrayView<FSPSwingState> States, float DeltaTime, const FSPSwingStepParams& Params);
+};
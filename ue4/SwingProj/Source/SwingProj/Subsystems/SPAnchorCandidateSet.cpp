@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPAnchorCandidateSet.h"
+
+#include "SwingProj.h"
+
+DECLARE_CYCLE_STAT(TEXT("Anchor Scoring"), STAT_SwingAnchorScoring, STATGROUP_Swing);
+
+void FSPAnchorCandidateSet::Reset()
+{
+	LocationsX.Reset();
+	LocationsY.Reset();
+	LocationsZ.Reset();
+	Types.Reset();
+	Visibility.Reset();
+	Actors.Reset();
+	NumCandidates = 0;
+}
+
+void FSPAnchorCandidateSet::Add(AInteractiveActor* Actor, const FVector& Location, EInteractiveActorType Type)
+{
+	if (NumCandidates == Actors.Num())
+	{
+		// Padding lanes keep the None type and are never selected
+		LocationsX.AddZeroed(SimdWidth);
+		LocationsY.AddZeroed(SimdWidth);
+		LocationsZ.AddZeroed(SimdWidth);
+		Types.AddZeroed(SimdWidth);
+		Visibility.AddZeroed(SimdWidth);
+		Actors.AddZeroed(SimdWidth);
+	}
+
+	LocationsX[NumCandidates] = Location.X;
+	LocationsY[NumCandidates] = Location.Y;
+	LocationsZ[NumCandidates] = Location.Z;
+	Types[NumCandidates] = (uint8)Type;
+	Visibility[NumCandidates] = 1;
+	Actors[NumCandidates] = Actor;
+	++NumCandidates;
+}
+
+int32 FSPAnchorCandidateSet::FindBestIndex(const FSPAnchorScoringParams& Params, float* OutBestScore) const
+{
+	SCOPE_SWING_STAT(AnchorScoring);
+	if (NumCandidates == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	static constexpr float RejectedScore = -MAX_flt;
+
+	const VectorRegister OriginX = VectorSetFloat1(Params.Origin.X);
+	const VectorRegister OriginY = VectorSetFloat1(Params.Origin.Y);
+	const VectorRegister OriginZ = VectorSetFloat1(Params.Origin.Z);
+	const VectorRegister ViewX = VectorSetFloat1(Params.ViewDirection.X);
+	const VectorRegister ViewY = VectorSetFloat1(Params.ViewDirection.Y);
+	const VectorRegister ViewZ = VectorSetFloat1(Params.ViewDirection.Z);
+	const VectorRegister MinCosine = VectorSetFloat1(Params.MinCosine);
+	const VectorRegister MaxDistanceSquared = VectorSetFloat1(FMath::Square(Params.MaxDistance));
+	const VectorRegister DistancePenalty = VectorSetFloat1(Params.DistanceWeight / FMath::Max(Params.MaxDistance, KINDA_SMALL_NUMBER));
+	const VectorRegister MinDistanceSquared = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister Rejected = VectorSetFloat1(RejectedScore);
+	const VectorRegister HysteresisBonus = VectorSetFloat1(Params.HysteresisBonus);
+	const VectorRegister PreviousIndex = VectorSetFloat1((float)Actors.IndexOfByKey(Params.PreviousActor));
+	const VectorRegister LaneStep = VectorSetFloat1((float)SimdWidth);
+	const uint8 RequiredType = (uint8)Params.RequiredType;
+
+	VectorRegister LaneIndices = MakeVectorRegister(0.f, 1.f, 2.f, 3.f);
+	VectorRegister BestScores = Rejected;
+	VectorRegister BestIndices = VectorSetFloat1(-1.f);
+
+	for (int32 i = 0; i < NumCandidates; i += SimdWidth)
+	{
+		const VectorRegister DeltaX = VectorSubtract(VectorLoad(&LocationsX[i]), OriginX);
+		const VectorRegister DeltaY = VectorSubtract(VectorLoad(&LocationsY[i]), OriginY);
+		const VectorRegister DeltaZ = VectorSubtract(VectorLoad(&LocationsZ[i]), OriginZ);
+
+		const VectorRegister DistanceSquared = VectorMultiplyAdd(DeltaZ, DeltaZ, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaX, DeltaX)));
+		const VectorRegister InvDistance = VectorReciprocalSqrt(VectorMax(DistanceSquared, MinDistanceSquared));
+		const VectorRegister Dot = VectorMultiplyAdd(DeltaZ, ViewZ, VectorMultiplyAdd(DeltaY, ViewY, VectorMultiply(DeltaX, ViewX)));
+		const VectorRegister Cosine = VectorMultiply(Dot, InvDistance);
+		const VectorRegister Distance = VectorMultiply(DistanceSquared, InvDistance);
+
+		const VectorRegister TypeMask = MakeVectorRegister(
+			Types[i] == RequiredType && Visibility[i] ? 0xFFFFFFFFu : 0u,
+			Types[i + 1] == RequiredType && Visibility[i + 1] ? 0xFFFFFFFFu : 0u,
+			Types[i + 2] == RequiredType && Visibility[i + 2] ? 0xFFFFFFFFu : 0u,
+			Types[i + 3] == RequiredType && Visibility[i + 3] ? 0xFFFFFFFFu : 0u);
+		const VectorRegister ValidMask = VectorBitwiseAnd(TypeMask, VectorBitwiseAnd(VectorCompareGT(Cosine, MinCosine), VectorCompareGE(MaxDistanceSquared, DistanceSquared)));
+
+		VectorRegister Score = VectorSubtract(Cosine, VectorMultiply(Distance, DistancePenalty));
+		Score = VectorAdd(Score, VectorBitwiseAnd(VectorCompareEQ(LaneIndices, PreviousIndex), HysteresisBonus));
+		Score = VectorSelect(ValidMask, Score, Rejected);
+
+		const VectorRegister BetterMask = VectorCompareGT(Score, BestScores);
+		BestScores = VectorSelect(BetterMask, Score, BestScores);
+		BestIndices = VectorSelect(BetterMask, LaneIndices, BestIndices);
+		LaneIndices = VectorAdd(LaneIndices, LaneStep);
+	}
+
+	MS_ALIGN(16) float LaneScores[SimdWidth] GCC_ALIGN(16);
+	MS_ALIGN(16) float LaneBestIndices[SimdWidth] GCC_ALIGN(16);
+	VectorStoreAligned(BestScores, LaneScores);
+	VectorStoreAligned(BestIndices, LaneBestIndices);
+
+	int32 BestIndex = INDEX_NONE;
+	float BestScore = RejectedScore;
+	for (int32 Lane = 0; Lane < SimdWidth; ++Lane)
+	{
+		if (LaneScores[Lane] > BestScore)
+		{
+			BestScore = LaneScores[Lane];
+			BestIndex = (int32)LaneBestIndices[Lane];
+		}
+	}
+
+	if (OutBestScore != nullptr && BestIndex != INDEX_NONE)
+	{
+		*OutBestScore = BestScore;
+	}
+	return BestIndex;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Actors/Interactive/InteractiveActor.h"
+
+struct FSPAnchorScoringParams
+{
+	FVector Origin = FVector::ZeroVector;
+	// Has to be normalized
+	FVector ViewDirection = FVector::ForwardVector;
+	float MinCosine = 0.35f;
+	float MaxDistance = 1500.f;
+	// Score lost by a candidate at MaxDistance compared to one at the origin
+	float DistanceWeight = 0.2f;
+	// Score added to PreviousActor so the selection does not flicker between similar candidates
+	float HysteresisBonus = 0.1f;
+	const AInteractiveActor* PreviousActor = nullptr;
+	EInteractiveActorType RequiredType = EInteractiveActorType::RopeSwingAttachment;
+};
+
+/**
+ * Structure of arrays of interactive actors in range, scored four at a time.
+ * Arrays are padded to a multiple of the SIMD width and keep their memory between frames.
+ */
+struct SWINGPROJ_API FSPAnchorCandidateSet
+{
+	static constexpr int32 SimdWidth = 4;
+	static constexpr int32 InlineCapacity = 64;
+
+	void Reset();
+	void Add(AInteractiveActor* Actor, const FVector& Location, EInteractiveActorType Type);
+
+	int32 Num() const { return NumCandidates; }
+	AInteractiveActor* GetActor(int32 Index) const { return Actors[Index]; }
+	FVector GetLocation(int32 Index) const { return FVector(LocationsX[Index], LocationsY[Index], LocationsZ[Index]); }
+	// Candidates start visible, hidden ones are never selected
+	void SetVisible(int32 Index, bool bIsVisible) { Visibility[Index] = bIsVisible ? 1 : 0; }
+	TArrayView<AInteractiveActor* const> GetActors() const { return MakeArrayView(Actors.GetData(), NumCandidates); }
+
+	// Returns the index of the best scored candidate or INDEX_NONE, does not allocate
+	int32 FindBestIndex(const FSPAnchorScoringParams& Params, float* OutBestScore = nullptr) const;
+
+private:
+	TArray<float, TInlineAllocator<InlineCapacity>> LocationsX;
+	TArray<float, TInlineAllocator<InlineCapacity>> LocationsY;
+	TArray<float, TInlineAllocator<InlineCapacity>> LocationsZ;
+	TArray<uint8, TInlineAllocator<InlineCapacity>> Types;
+	TArray<uint8, TInlineAllocator<InlineCapacity>> Visibility;
+	TArray<AInteractiveActor*, TInlineAllocator<InlineCapacity>> Actors;
+	int32 NumCandidates = 0;
+};
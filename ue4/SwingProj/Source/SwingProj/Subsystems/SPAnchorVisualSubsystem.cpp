@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPAnchorVisualSubsystem.h"
+
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "SwingProj.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anchor Visual Instances"), STAT_SwingAnchorVisualInstances, STATGROUP_Swing);
+
+FSPAnchorVisualHandle USPAnchorVisualSubsystem::AddInstance(const UStaticMeshComponent* Template, const FTransform& Transform)
+{
+	FSPAnchorVisualHandle Handle;
+	// Nothing is rendered on a dedicated server, an invalid handle leaves the anchor as it is
+	if (GetWorld()->IsNetMode(NM_DedicatedServer) || !IsValid(Template) || Template->GetStaticMesh() == nullptr)
+	{
+		return Handle;
+	}
+
+	Handle.BatchIndex = FindOrAddBatch(Template);
+	if (Handle.BatchIndex == INDEX_NONE)
+	{
+		return Handle;
+	}
+
+	FBatch& Batch = Batches[Handle.BatchIndex];
+	const int32 InstanceIndex = Batch.Component->AddInstanceWorldSpace(Transform);
+	Handle.Id = Batch.FreeIds.Num() > 0 ? Batch.FreeIds.Pop(false) : Batch.IdToInstance.AddUninitialized();
+	Batch.IdToInstance[Handle.Id] = InstanceIndex;
+	Batch.InstanceToId.Add(Handle.Id);
+	check(Batch.InstanceToId.Num() == InstanceIndex + 1);
+
+	INC_DWORD_STAT(STAT_SwingAnchorVisualInstances);
+	return Handle;
+}
+
+void USPAnchorVisualSubsystem::UpdateInstanceTransform(const FSPAnchorVisualHandle& Handle, const FTransform& Transform)
+{
+	const int32 InstanceIndex = GetInstanceIndex(Handle);
+	if (InstanceIndex != INDEX_NONE)
+	{
+		Batches[Handle.BatchIndex].Component->UpdateInstanceTransform(InstanceIndex, Transform, true, true, true);
+	}
+}
+
+void USPAnchorVisualSubsystem::RemoveInstance(FSPAnchorVisualHandle& Handle)
+{
+	const int32 InstanceIndex = GetInstanceIndex(Handle);
+	if (InstanceIndex == INDEX_NONE)
+	{
+		Handle = FSPAnchorVisualHandle();
+		return;
+	}
+
+	// The last instance fills the gap, removing only the last index keeps every other index valid
+	FBatch& Batch = Batches[Handle.BatchIndex];
+	const int32 LastIndex = Batch.InstanceToId.Num() - 1;
+	if (InstanceIndex != LastIndex)
+	{
+		FTransform LastTransform;
+		Batch.Component->GetInstanceTransform(LastIndex, LastTransform, true);
+		Batch.Component->UpdateInstanceTransform(InstanceIndex, LastTransform, true, false, true);
+
+		const int32 LastId = Batch.InstanceToId[LastIndex];
+		Batch.InstanceToId[InstanceIndex] = LastId;
+		Batch.IdToInstance[LastId] = InstanceIndex;
+	}
+	Batch.Component->RemoveInstance(LastIndex);
+	Batch.InstanceToId.Pop(false);
+	Batch.IdToInstance[Handle.Id] = INDEX_NONE;
+	Batch.FreeIds.Add(Handle.Id);
+
+	DEC_DWORD_STAT(STAT_SwingAnchorVisualInstances);
+	Handle = FSPAnchorVisualHandle();
+}
+
+UHierarchicalInstancedStaticMeshComponent* USPAnchorVisualSubsystem::GetInstanceComponent(const FSPAnchorVisualHandle& Handle) const
+{
+	return Batches.IsValidIndex(Handle.BatchIndex) ? Batches[Handle.BatchIndex].Component : nullptr;
+}
+
+int32 USPAnchorVisualSubsystem::GetInstanceIndex(const FSPAnchorVisualHandle& Handle) const
+{
+	if (!Batches.IsValidIndex(Handle.BatchIndex) || !IsValid(Batches[Handle.BatchIndex].Component))
+	{
+		return INDEX_NONE;
+	}
+
+	const FBatch& Batch = Batches[Handle.BatchIndex];
+	return Batch.IdToInstance.IsValidIndex(Handle.Id) ? Batch.IdToInstance[Handle.Id] : INDEX_NONE;
+}
+
+int32 USPAnchorVisualSubsystem::FindOrAddBatch(const UStaticMeshComponent* Template)
+{
+	const UStaticMesh* Mesh = Template->GetStaticMesh();
+	if (const int32* BatchIndex = BatchByMesh.Find(Mesh))
+	{
+		return *BatchIndex;
+	}
+
+	if (!IsValid(VisualActor))
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		VisualActor = GetWorld()->SpawnActor<AActor>(SpawnParameters);
+		if (!IsValid(VisualActor))
+		{
+			return INDEX_NONE;
+		}
+
+		USceneComponent* VisualRoot = NewObject<USceneComponent>(VisualActor, FName(TEXT("Root")));
+		VisualActor->SetRootComponent(VisualRoot);
+		VisualRoot->RegisterComponent();
+	}
+
+	// Collision stays on the anchors' own components, so traces can still ignore a single anchor actor
+	UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(VisualActor);
+	Component->SetStaticMesh(const_cast<UStaticMesh*>(Mesh));
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetCastShadow(Template->CastShadow);
+	for (int32 MaterialIndex = 0; MaterialIndex < Template->GetNumMaterials(); ++MaterialIndex)
+	{
+		Component->SetMaterial(MaterialIndex, Template->GetMaterial(MaterialIndex));
+	}
+	Component->SetupAttachment(VisualActor->GetRootComponent());
+	Component->RegisterComponent();
+	InstanceComponents.Add(Component);
+
+	FBatch Batch;
+	Batch.Component = Component;
+	const int32 BatchIndex = Batches.Add(MoveTemp(Batch));
+	BatchByMesh.Add(Mesh, BatchIndex);
+	return BatchIndex;
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SPAnchorVisualSubsystem.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+class UStaticMeshComponent;
+
+// Stays valid while other instances of the same mesh are added and removed
+struct FSPAnchorVisualHandle
+{
+	int32 BatchIndex = INDEX_NONE;
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return BatchIndex != INDEX_NONE && Id != INDEX_NONE; }
+};
+
+/**
+ * Renders the meshes of all anchors through one hierarchical instanced static mesh component per static mesh.
+ * Materials, shadows and the like are taken from the first component registered with a mesh.
+ */
+UCLASS()
+class SWINGPROJ_API USPAnchorVisualSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	FSPAnchorVisualHandle AddInstance(const UStaticMeshComponent* Template, const FTransform& Transform);
+	void UpdateInstanceTransform(const FSPAnchorVisualHandle& Handle, const FTransform& Transform);
+	void RemoveInstance(FSPAnchorVisualHandle& Handle);
+
+	UHierarchicalInstancedStaticMeshComponent* GetInstanceComponent(const FSPAnchorVisualHandle& Handle) const;
+	int32 GetInstanceIndex(const FSPAnchorVisualHandle& Handle) const;
+
+	int32 GetNumBatches() const { return Batches.Num(); }
+
+private:
+	struct FBatch
+	{
+		UHierarchicalInstancedStaticMeshComponent* Component = nullptr;
+		TArray<int32> InstanceToId;
+		TArray<int32> IdToInstance;
+		TArray<int32> FreeIds;
+	};
+
+	int32 FindOrAddBatch(const UStaticMeshComponent* Template);
+
+	TArray<FBatch> Batches;
+	TMap<const UStaticMesh*, int32> BatchByMesh;
+
+	UPROPERTY(Transient)
+	AActor* VisualActor;
+
+	// Keeps the batch components referenced
+	UPROPERTY(Transient)
+	TArray<UHierarchicalInstancedStaticMeshComponent*> InstanceComponents;
+};
@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPHookProjectileSubsystem.h"
+
+#include "Actors/Interactive/RopeSwingAttachmentActor.h"
+#include "Characters/SwingProjCharacter.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "SwingProj.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hooks in Flight"), STAT_SwingHooksInFlight, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Hook Projectiles"), STAT_SwingHookProjectiles, STATGROUP_Swing);
+
+void USPHookProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Hooks.Reserve(MaxHooksInFlight);
+	FinishedHooks.Reserve(MaxHooksInFlight);
+}
+
+bool USPHookProjectileSubsystem::Launch(ASwingProjCharacter* Thrower, ARopeSwingAttachmentActor* Target, const FVector& StartLocation, UStaticMeshComponent* HookVisual)
+{
+	if (Hooks.Num() >= MaxHooksInFlight || !IsValid(Thrower) || !IsValid(Target))
+	{
+		return false;
+	}
+
+	// A character has one rope, a new throw replaces the hook still in flight
+	Cancel(Thrower);
+
+	FHookProjectile& Hook = Hooks.AddDefaulted_GetRef();
+	Hook.Thrower = Thrower;
+	Hook.Target = Target;
+	Hook.HookVisual = HookVisual;
+	Hook.Location = StartLocation;
+	if (IsValid(HookVisual))
+	{
+		HookVisual->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+		HookVisual->SetWorldLocation(StartLocation);
+	}
+	return true;
+}
+
+void USPHookProjectileSubsystem::Cancel(ASwingProjCharacter* Thrower)
+{
+	for (int32 Index = Hooks.Num() - 1; Index >= 0; --Index)
+	{
+		if (Hooks[Index].Thrower == Thrower)
+		{
+			Hooks.RemoveAtSwap(Index, 1, false);
+		}
+	}
+}
+
+void USPHookProjectileSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_SWING_STAT(HookProjectiles);
+	FSPSwingAllocationScope AllocationScope;
+	SET_DWORD_STAT(STAT_SwingHooksInFlight, Hooks.Num());
+
+	FinishedHooks.Reset();
+	for (int32 Index = Hooks.Num() - 1; Index >= 0; --Index)
+	{
+		FHookProjectile& Hook = Hooks[Index];
+		// Released pooled anchors are hidden and may be reused for another record
+		const bool bHasTarget = Hook.Target.IsValid() && !Hook.Target->IsHidden();
+		const EHookResult Result = Hook.Thrower.IsValid() && bHasTarget ? StepHook(Hook, DeltaTime) : EHookResult::Missed;
+		if (Result != EHookResult::InFlight)
+		{
+			if (Hook.Thrower.IsValid())
+			{
+				FinishedHooks.Emplace(Hook.Thrower, Result);
+			}
+			Hooks.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	for (const TPair<TWeakObjectPtr<ASwingProjCharacter>, EHookResult>& FinishedHook : FinishedHooks)
+	{
+		// An earlier callback may have destroyed it
+		ASwingProjCharacter* Thrower = FinishedHook.Key.Get();
+		if (!IsValid(Thrower))
+		{
+			continue;
+		}
+
+		if (FinishedHook.Value == EHookResult::Attached)
+		{
+			Thrower->OnHookContact();
+		}
+		else
+		{
+			Thrower->OnHookMissed();
+		}
+	}
+}
+
+USPHookProjectileSubsystem::EHookResult USPHookProjectileSubsystem::StepHook(FHookProjectile& Hook, float DeltaTime) const
+{
+	Hook.FlightTime += DeltaTime;
+
+	// Homes in on the anchor, which may move while the hook is out
+	const FVector TargetLocation = Hook.Target->GetActorLocation();
+	const FVector ToTarget = TargetLocation - Hook.Location;
+	const float Distance = ToTarget.Size();
+	const float StepDistance = HookSpeed * DeltaTime;
+	const bool bReachesTarget = Distance <= StepDistance;
+	const FVector NewLocation = bReachesTarget ? TargetLocation : Hook.Location + ToTarget * (StepDistance / Distance);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HookProjectile), false, Hook.Thrower.Get());
+	QueryParams.AddIgnoredActor(Hook.Target.Get());
+	if (GetWorld()->LineTraceTestByChannel(Hook.Location, NewLocation, TraceChannel, QueryParams))
+	{
+		return EHookResult::Missed;
+	}
+
+	Hook.Location = NewLocation;
+	if (Hook.HookVisual.IsValid())
+	{
+		Hook.HookVisual->SetWorldLocation(NewLocation);
+	}
+
+	if (bReachesTarget)
+	{
+		return EHookResult::Attached;
+	}
+	return Hook.FlightTime >= MaxFlightTime ? EHookResult::Missed : EHookResult::InFlight;
+}
+
+ETickableTickType USPHookProjectileSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool USPHookProjectileSubsystem::IsTickable() const
+{
+	return Hooks.Num() > 0;
+}
+
+TStatId USPHookProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USPHookProjectileSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SPHookProjectileSubsystem.generated.h"
+
+class ARopeSwingAttachmentActor;
+class ASwingProjCharacter;
+class UStaticMeshComponent;
+
+/**
+ * Thrown rope hooks of a world, kept as plain records and moved and traced together once per frame.
+ * A hook flies towards its anchor and attaches its thrower on contact, a hook that hits the level on the way drops the rope.
+ */
+UCLASS(config = Game)
+class SWINGPROJ_API USPHookProjectileSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// HookVisual is moved along with the hook and may be null, e.g. on a dedicated server. Fails when MaxHooksInFlight hooks are out already
+	bool Launch(ASwingProjCharacter* Thrower, ARopeSwingAttachmentActor* Target, const FVector& StartLocation, UStaticMeshComponent* HookVisual);
+	void Cancel(ASwingProjCharacter* Thrower);
+
+	int32 GetNumHooksInFlight() const { return Hooks.Num(); }
+	float GetHookSpeed() const { return HookSpeed; }
+	float GetMaxFlightTime() const { return MaxFlightTime; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	UPROPERTY(Config)
+	float HookSpeed = 4000.f;
+
+	// A hook that has not reached its anchor by then is dropped
+	UPROPERTY(Config)
+	float MaxFlightTime = 1.f;
+
+	// Hook records are allocated once for this many hooks
+	UPROPERTY(Config)
+	int32 MaxHooksInFlight = 128;
+
+	UPROPERTY(Config)
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+private:
+	struct FHookProjectile
+	{
+		TWeakObjectPtr<ASwingProjCharacter> Thrower;
+		TWeakObjectPtr<ARopeSwingAttachmentActor> Target;
+		TWeakObjectPtr<UStaticMeshComponent> HookVisual;
+		FVector Location = FVector::ZeroVector;
+		float FlightTime = 0.f;
+	};
+
+	enum class EHookResult : uint8
+	{
+		InFlight,
+		Attached,
+		Missed
+	};
+
+	EHookResult StepHook(FHookProjectile& Hook, float DeltaTime) const;
+
+	// Hooks don't keep their actors alive, a hook whose thrower or target is gone is dropped on the next tick
+	TArray<FHookProjectile> Hooks;
+
+	// Throwers whose hook finished this tick, called once all hooks moved since attaching may change the hook list
+	TArray<TPair<TWeakObjectPtr<ASwingProjCharacter>, EHookResult>> FinishedHooks;
+};
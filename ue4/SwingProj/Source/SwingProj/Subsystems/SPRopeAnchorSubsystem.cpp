@@ -0,0 +1,385 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPRopeAnchorSubsystem.h"
+
+#include "Actors/Interactive/SPAnchorDataActor.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "SPAnchorCandidateSet.h"
+#include "SwingProj.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Interactive Actors"), STAT_SwingRegisteredInteractiveActors, STATGROUP_Swing);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Data Anchors"), STAT_SwingDataAnchors, STATGROUP_Swing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Instanced Data Anchors"), STAT_SwingInstancedDataAnchors, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Anchor Query"), STAT_SwingAnchorQuery, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Anchor Instancing"), STAT_SwingAnchorInstancing, STATGROUP_Swing);
+
+void USPRopeAnchorSubsystem::RegisterInteractiveActor(AInteractiveActor* InteractiveActor)
+{
+	if (!IsValid(InteractiveActor) || InteractiveActor->SpatialHandle != INDEX_NONE)
+	{
+		return;
+	}
+
+	FAnchorEntry Entry;
+	Entry.Actor = InteractiveActor;
+	Entry.Location = InteractiveActor->GetActorLocation();
+	Entry.InteractionRadius = InteractiveActor->GetInteractionRadius();
+	Entry.Type = InteractiveActor->GetInteractiveActorType();
+	Entry.Cell = GetCell(Entry.Location);
+
+	const int32 EntryIndex = Entries.Add(Entry);
+	AddToCell(Entry.Cell, EntryIndex);
+	InteractiveActor->SpatialHandle = EntryIndex;
+	INC_DWORD_STAT(STAT_SwingRegisteredInteractiveActors);
+	MaxInteractionRadius = FMath::Max(MaxInteractionRadius, Entry.InteractionRadius);
+}
+
+void USPRopeAnchorSubsystem::UnregisterInteractiveActor(AInteractiveActor* InteractiveActor)
+{
+	if (InteractiveActor == nullptr || !Entries.IsValidIndex(InteractiveActor->SpatialHandle))
+	{
+		return;
+	}
+
+	const int32 EntryIndex = InteractiveActor->SpatialHandle;
+	if (Entries[EntryIndex].DataSource != nullptr)
+	{
+		// The record stays, only its instance goes away
+		Entries[EntryIndex].Actor = nullptr;
+		InteractiveActor->SpatialHandle = INDEX_NONE;
+		InstancedEntries.RemoveSwap(EntryIndex);
+		return;
+	}
+
+	RemoveFromCell(Entries[EntryIndex].Cell, EntryIndex);
+	Entries.RemoveAt(EntryIndex);
+	InteractiveActor->SpatialHandle = INDEX_NONE;
+	DEC_DWORD_STAT(STAT_SwingRegisteredInteractiveActors);
+}
+
+void USPRopeAnchorSubsystem::UpdateInteractiveActorLocation(AInteractiveActor* InteractiveActor)
+{
+	if (!IsValid(InteractiveActor) || !Entries.IsValidIndex(InteractiveActor->SpatialHandle))
+	{
+		return;
+	}
+
+	const int32 EntryIndex = InteractiveActor->SpatialHandle;
+	FAnchorEntry& Entry = Entries[EntryIndex];
+	Entry.Location = InteractiveActor->GetActorLocation();
+
+	// Only a move across a cell border touches the hash
+	const FIntVector NewCell = GetCell(Entry.Location);
+	if (NewCell != Entry.Cell)
+	{
+		RemoveFromCell(Entry.Cell, EntryIndex);
+		AddToCell(NewCell, EntryIndex);
+		Entry.Cell = NewCell;
+	}
+}
+
+void USPRopeAnchorSubsystem::UpdateInteractiveActorRadius(AInteractiveActor* InteractiveActor)
+{
+	if (!IsValid(InteractiveActor) || !Entries.IsValidIndex(InteractiveActor->SpatialHandle))
+	{
+		return;
+	}
+
+	FAnchorEntry& Entry = Entries[InteractiveActor->SpatialHandle];
+	Entry.InteractionRadius = InteractiveActor->GetInteractionRadius();
+	MaxInteractionRadius = FMath::Max(MaxInteractionRadius, Entry.InteractionRadius);
+}
+
+bool USPRopeAnchorSubsystem::GetAvailableAnchorData(const AInteractiveActor* InteractiveActor, FVector& OutLocation, float& OutInteractionRadius) const
+{
+	if (!IsValid(InteractiveActor) || !Entries.IsValidIndex(InteractiveActor->SpatialHandle))
+	{
+		return false;
+	}
+
+	const FAnchorEntry& Entry = Entries[InteractiveActor->SpatialHandle];
+	if (Entry.Actor != InteractiveActor || !IsEntryAvailable(Entry))
+	{
+		return false;
+	}
+
+	OutLocation = Entry.Location;
+	OutInteractionRadius = Entry.InteractionRadius;
+	return true;
+}
+
+void USPRopeAnchorSubsystem::RegisterAnchorData(ASPAnchorDataActor* DataActor)
+{
+	if (!IsValid(DataActor) || DataActor->EntryHandles.Num() > 0)
+	{
+		return;
+	}
+
+	const EInteractiveActorType Type = DataActor->GetAnchorType();
+	DataActor->EntryHandles.Reserve(DataActor->GetNumRecords());
+	for (int32 RecordIndex = 0; RecordIndex < DataActor->GetNumRecords(); ++RecordIndex)
+	{
+		FAnchorEntry Entry;
+		Entry.Location = DataActor->GetRecordTransform(RecordIndex).GetLocation();
+		Entry.InteractionRadius = DataActor->GetRecord(RecordIndex).InteractionRadius;
+		Entry.Type = Type;
+		Entry.Cell = GetCell(Entry.Location);
+		Entry.DataSource = DataActor;
+		Entry.RecordIndex = RecordIndex;
+
+		const int32 EntryIndex = Entries.Add(Entry);
+		AddToCell(Entry.Cell, EntryIndex);
+		DataActor->EntryHandles.Add(EntryIndex);
+		MaxInteractionRadius = FMath::Max(MaxInteractionRadius, Entry.InteractionRadius);
+	}
+
+	NumDataEntries += DataActor->EntryHandles.Num();
+	INC_DWORD_STAT_BY(STAT_SwingDataAnchors, DataActor->EntryHandles.Num());
+}
+
+void USPRopeAnchorSubsystem::UnregisterAnchorData(ASPAnchorDataActor* DataActor)
+{
+	if (DataActor == nullptr)
+	{
+		return;
+	}
+
+	for (const int32 EntryIndex : DataActor->EntryHandles)
+	{
+		if (Entries[EntryIndex].Actor != nullptr)
+		{
+			ReleaseEntry(EntryIndex);
+		}
+		RemoveFromCell(Entries[EntryIndex].Cell, EntryIndex);
+		Entries.RemoveAt(EntryIndex);
+	}
+
+	NumDataEntries -= DataActor->EntryHandles.Num();
+	DEC_DWORD_STAT_BY(STAT_SwingDataAnchors, DataActor->EntryHandles.Num());
+	DataActor->EntryHandles.Reset();
+}
+
+void USPRopeAnchorSubsystem::QueryInRadius(const FVector& Location, float Radius, TArray<AInteractiveActor*>& OutActors) const
+{
+	SCOPE_SWING_STAT(AnchorQuery);
+	const float RadiusSquared = FMath::Square(Radius);
+	ForEachEntryInRadius(Location, Radius, [&](const FAnchorEntry& Entry, int32 EntryIndex)
+	{
+		if (IsEntryAvailable(Entry) && FVector::DistSquared(Entry.Location, Location) <= RadiusSquared)
+		{
+			OutActors.Add(Entry.Actor);
+		}
+	});
+}
+
+void USPRopeAnchorSubsystem::GatherAvailableInteractiveActors(const FVector& Location, TArray<AInteractiveActor*>& OutActors) const
+{
+	SCOPE_SWING_STAT(AnchorQuery);
+	ForEachEntryInRadius(Location, MaxInteractionRadius, [&](const FAnchorEntry& Entry, int32 EntryIndex)
+	{
+		if (IsEntryAvailable(Entry) && FVector::DistSquared(Entry.Location, Location) <= FMath::Square(Entry.InteractionRadius))
+		{
+			OutActors.Add(Entry.Actor);
+		}
+	});
+}
+
+void USPRopeAnchorSubsystem::GatherAvailableInteractiveActors(const FVector& Location, FSPAnchorCandidateSet& OutCandidates) const
+{
+	SCOPE_SWING_STAT(AnchorQuery);
+	ForEachEntryInRadius(Location, MaxInteractionRadius, [&](const FAnchorEntry& Entry, int32 EntryIndex)
+	{
+		if (IsEntryAvailable(Entry) && FVector::DistSquared(Entry.Location, Location) <= FMath::Square(Entry.InteractionRadius))
+		{
+			OutCandidates.Add(Entry.Actor, Entry.Location, Entry.Type);
+		}
+	});
+}
+
+void USPRopeAnchorSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_SWING_STAT(AnchorInstancing);
+
+	PawnLocations.Reset();
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		const AController* Controller = It->Get();
+		if (IsValid(Controller) && IsValid(Controller->GetPawn()))
+		{
+			PawnLocations.Add(Controller->GetPawn()->GetActorLocation());
+		}
+	}
+
+	const uint64 Frame = GFrameCounter;
+	EntriesToInstantiate.Reset();
+	for (const FVector& PawnLocation : PawnLocations)
+	{
+		ForEachEntryInRadius(PawnLocation, MaxInteractionRadius + 2.f * InstanceMargin, [&](const FAnchorEntry& Entry, int32 EntryIndex)
+		{
+			if (Entry.DataSource == nullptr || Entry.LastRelevantFrame == Frame)
+			{
+				return;
+			}
+
+			// Instanced anchors are kept up to twice the margin so a pawn on the border does not cycle them
+			const float DistanceSquared = FVector::DistSquared(Entry.Location, PawnLocation);
+			const float Margin = Entry.Actor != nullptr ? 2.f * InstanceMargin : InstanceMargin;
+			if (DistanceSquared <= FMath::Square(Entry.InteractionRadius + Margin))
+			{
+				Entries[EntryIndex].LastRelevantFrame = Frame;
+				if (Entry.Actor == nullptr)
+				{
+					EntriesToInstantiate.Add(EntryIndex);
+				}
+			}
+		});
+	}
+
+	for (int32 i = InstancedEntries.Num() - 1; i >= 0; --i)
+	{
+		const FAnchorEntry& Entry = Entries[InstancedEntries[i]];
+		if (Entry.LastRelevantFrame != Frame && !Entry.Actor->IsInteracting())
+		{
+			ReleaseEntry(InstancedEntries[i]);
+		}
+	}
+
+	for (const int32 EntryIndex : EntriesToInstantiate)
+	{
+		InstantiateEntry(EntryIndex);
+	}
+
+	SET_DWORD_STAT(STAT_SwingInstancedDataAnchors, InstancedEntries.Num());
+}
+
+ETickableTickType USPRopeAnchorSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool USPRopeAnchorSubsystem::IsTickable() const
+{
+	// Clients receive the instances the server spawns
+	return NumDataEntries > 0 && GetWorld()->GetNetMode() != NM_Client;
+}
+
+TStatId USPRopeAnchorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USPRopeAnchorSubsystem, STATGROUP_Tickables);
+}
+
+void USPRopeAnchorSubsystem::InstantiateEntry(int32 EntryIndex)
+{
+	FAnchorEntry& Entry = Entries[EntryIndex];
+	UClass* AnchorClass = Entry.DataSource->GetAnchorClass();
+	if (AnchorClass == nullptr)
+	{
+		return;
+	}
+
+	const FTransform AnchorTransform = Entry.DataSource->GetRecordTransform(Entry.RecordIndex);
+	InstancePool.RemoveAllSwap([](const AInteractiveActor* Actor) { return !IsValid(Actor); });
+	const int32 PoolIndex = InstancePool.IndexOfByPredicate([AnchorClass](const AInteractiveActor* Actor) { return Actor->GetClass() == AnchorClass; });
+
+	AInteractiveActor* Actor = nullptr;
+	if (PoolIndex != INDEX_NONE)
+	{
+		// Moved while it has no handle, so the spatial hash does not see the transform change
+		Actor = InstancePool[PoolIndex];
+		InstancePool.RemoveAtSwap(PoolIndex, 1, false);
+		Actor->SetActorTransform(AnchorTransform, false, nullptr, ETeleportType::TeleportPhysics);
+		Actor->SetActorHiddenInGame(false);
+		Actor->SetActorEnableCollision(true);
+	}
+	else
+	{
+		// A preset handle keeps BeginPlay from registering the actor a second time
+		Actor = GetWorld()->SpawnActorDeferred<AInteractiveActor>(AnchorClass, AnchorTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		Actor->SpatialHandle = EntryIndex;
+		Actor->SetReplicates(true);
+		Actor->SetReplicateMovement(true);
+		Actor->FinishSpawning(AnchorTransform);
+	}
+
+	Actor->SpatialHandle = EntryIndex;
+	Entry.Actor = Actor;
+	// Replicated, clients register the instance with the record's radius
+	Actor->SetInteractionRadius(Entry.InteractionRadius);
+	InstancedEntries.Add(EntryIndex);
+}
+
+void USPRopeAnchorSubsystem::ReleaseEntry(int32 EntryIndex)
+{
+	FAnchorEntry& Entry = Entries[EntryIndex];
+	AInteractiveActor* Actor = Entry.Actor;
+	Entry.Actor = nullptr;
+	InstancedEntries.RemoveSwap(EntryIndex);
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	Actor->SpatialHandle = INDEX_NONE;
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	InstancePool.Add(Actor);
+}
+
+FIntVector USPRopeAnchorSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void USPRopeAnchorSubsystem::AddToCell(const FIntVector& Cell, int32 EntryIndex)
+{
+	Cells.FindOrAdd(Cell).Add(EntryIndex);
+}
+
+void USPRopeAnchorSubsystem::RemoveFromCell(const FIntVector& Cell, int32 EntryIndex)
+{
+	TArray<int32>* CellEntries = Cells.Find(Cell);
+	if (CellEntries == nullptr)
+	{
+		return;
+	}
+
+	CellEntries->RemoveSingleSwap(EntryIndex, false);
+	if (CellEntries->Num() == 0)
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+template<typename PredicateType>
+void USPRopeAnchorSubsystem::ForEachEntryInRadius(const FVector& Location, float Radius, PredicateType Predicate) const
+{
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	const FIntVector MinCell = GetCell(Location - FVector(Radius));
+	const FIntVector MaxCell = GetCell(Location + FVector(Radius));
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32>* CellEntries = Cells.Find(FIntVector(X, Y, Z));
+				if (CellEntries == nullptr)
+				{
+					continue;
+				}
+
+				for (const int32 EntryIndex : *CellEntries)
+				{
+					Predicate(Entries[EntryIndex], EntryIndex);
+				}
+			}
+		}
+	}
+}
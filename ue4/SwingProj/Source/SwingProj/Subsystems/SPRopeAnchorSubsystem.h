@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Actors/Interactive/InteractiveActor.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SPRopeAnchorSubsystem.generated.h"
+
+class ASPAnchorDataActor;
+struct FSPAnchorCandidateSet;
+
+/**
+ * Uniform spatial hash of all interactive actors in the world, replaces per-actor overlap volumes.
+ * Anchors authored as data records get a pooled actor only while a pawn is close to them.
+ */
+UCLASS(config = Game)
+class SWINGPROJ_API USPRopeAnchorSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterInteractiveActor(AInteractiveActor* InteractiveActor);
+	void UnregisterInteractiveActor(AInteractiveActor* InteractiveActor);
+	void UpdateInteractiveActorLocation(AInteractiveActor* InteractiveActor);
+	void UpdateInteractiveActorRadius(AInteractiveActor* InteractiveActor);
+
+	void RegisterAnchorData(ASPAnchorDataActor* DataActor);
+	void UnregisterAnchorData(ASPAnchorDataActor* DataActor);
+
+	// Appends every registered actor within Radius of Location to OutActors
+	void QueryInRadius(const FVector& Location, float Radius, TArray<AInteractiveActor*>& OutActors) const;
+
+	// Appends every registered actor whose own interaction radius contains Location
+	void GatherAvailableInteractiveActors(const FVector& Location, TArray<AInteractiveActor*>& OutActors) const;
+	void GatherAvailableInteractiveActors(const FVector& Location, FSPAnchorCandidateSet& OutCandidates) const;
+
+	// Location and radius the hash knows the actor by, false when it is not registered or not available
+	bool GetAvailableAnchorData(const AInteractiveActor* InteractiveActor, FVector& OutLocation, float& OutInteractionRadius) const;
+
+	int32 GetNumRegisteredInteractiveActors() const { return Entries.Num(); }
+
+	void OnInteractiveActorInteractingChanged(bool bIsInteracting) { NumInteractingActors += bIsInteracting ? 1 : -1; }
+	int32 GetNumInteractingActors() const { return NumInteractingActors; }
+
+	int32 GetNumDataAnchors() const { return NumDataEntries; }
+	int32 GetNumInstancedDataAnchors() const { return InstancedEntries.Num(); }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	// Should be close to the typical interaction radius, so a query touches only a few cells
+	UPROPERTY(Config)
+	float CellSize = 400.f;
+
+	// Data anchors get an actor once a pawn is within their interaction radius plus this margin, and lose it beyond twice the margin
+	UPROPERTY(Config)
+	float InstanceMargin = 300.f;
+
+private:
+	struct FAnchorEntry
+	{
+		AInteractiveActor* Actor = nullptr;
+		FVector Location = FVector::ZeroVector;
+		float InteractionRadius = 0.f;
+		EInteractiveActorType Type = EInteractiveActorType::None;
+		FIntVector Cell = FIntVector::ZeroValue;
+		// Set for data anchors, Actor is then only valid while the anchor is instanced
+		ASPAnchorDataActor* DataSource = nullptr;
+		int32 RecordIndex = INDEX_NONE;
+		uint64 LastRelevantFrame = 0;
+	};
+
+	static bool IsEntryAvailable(const FAnchorEntry& Entry) { return Entry.Actor != nullptr && !Entry.Actor->IsHidden(); }
+
+	void InstantiateEntry(int32 EntryIndex);
+	void ReleaseEntry(int32 EntryIndex);
+
+	FIntVector GetCell(const FVector& Location) const;
+	void AddToCell(const FIntVector& Cell, int32 EntryIndex);
+	void RemoveFromCell(const FIntVector& Cell, int32 EntryIndex);
+
+	template<typename PredicateType>
+	void ForEachEntryInRadius(const FVector& Location, float Radius, PredicateType Predicate) const;
+
+	TSparseArray<FAnchorEntry> Entries;
+	TMap<FIntVector, TArray<int32>> Cells;
+	float MaxInteractionRadius = 0.f;
+	int32 NumInteractingActors = 0;
+
+	int32 NumDataEntries = 0;
+	TArray<int32> InstancedEntries;
+	TArray<int32> EntriesToInstantiate;
+	TArray<FVector, TInlineAllocator<8>> PawnLocations;
+
+	// Hidden actors of released data anchors, reused by the next anchor of the same class
+	UPROPERTY(Transient)
+	TArray<AInteractiveActor*> InstancePool;
+};
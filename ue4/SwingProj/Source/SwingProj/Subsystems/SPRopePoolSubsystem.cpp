@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPRopePoolSubsystem.h"
+
+#include "Components/RopeComponents/SPRopeComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "SwingProj.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Leased Ropes"), STAT_SwingLeasedRopes, STATGROUP_Swing);
+
+FSPRopeLease USPRopePoolSubsystem::Lease(UStaticMesh* HookStaticMesh, UMaterialInterface* RopeMaterial, float RopeWidth)
+{
+	FSPRopeLease RopeLease;
+	if (!IsValid(PoolActor))
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Name = FName(TEXT("RopePool"));
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		PoolActor = GetWorld()->SpawnActor<AActor>(SpawnParameters);
+		if (!IsValid(PoolActor))
+		{
+			return RopeLease;
+		}
+
+		USceneComponent* PoolRoot = NewObject<USceneComponent>(PoolActor, FName(TEXT("Root")));
+		PoolActor->SetRootComponent(PoolRoot);
+		PoolRoot->RegisterComponent();
+		FreeRopes.Reset();
+		FreeHooks.Reset();
+	}
+
+	if (FreeRopes.Num() > 0)
+	{
+		RopeLease.Rope = FreeRopes.Pop(false);
+		RopeLease.Hook = FreeHooks.Pop(false);
+	}
+	else
+	{
+		RopeLease.Hook = NewObject<UStaticMeshComponent>(PoolActor);
+		RopeLease.Hook->SetMobility(EComponentMobility::Movable);
+		RopeLease.Hook->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		RopeLease.Hook->SetGenerateOverlapEvents(false);
+		RopeLease.Hook->SetupAttachment(PoolActor->GetRootComponent());
+		RopeLease.Hook->RegisterComponent();
+
+		RopeLease.Rope = NewObject<USPRopeComponent>(PoolActor);
+		RopeLease.Rope->SetupAttachment(PoolActor->GetRootComponent());
+		RopeLease.Rope->RegisterComponent();
+		RopeLease.Rope->SetAttachEndToComponent(RopeLease.Hook);
+	}
+
+	// Set before the rope becomes visible, the scene proxy is created with them
+	RopeLease.Hook->SetStaticMesh(HookStaticMesh);
+	if (RopeMaterial != nullptr)
+	{
+		RopeLease.Rope->SetMaterial(0, RopeMaterial);
+	}
+	RopeLease.Rope->RopeWidth = RopeWidth;
+	RopeLease.Rope->SetWrapPoints(TArrayView<const FVector>());
+	RopeLease.Rope->SetSimulationEnabled(false);
+
+	RopeLease.Hook->SetVisibility(true);
+	RopeLease.Rope->SetVisibility(true);
+
+	++NumLeased;
+	SET_DWORD_STAT(STAT_SwingLeasedRopes, NumLeased);
+	return RopeLease;
+}
+
+void USPRopePoolSubsystem::Release(FSPRopeLease& RopeLease)
+{
+	if (!RopeLease.IsValid())
+	{
+		return;
+	}
+
+	--NumLeased;
+	SET_DWORD_STAT(STAT_SwingLeasedRopes, NumLeased);
+
+	USPRopeComponent* Rope = RopeLease.Rope;
+	UStaticMeshComponent* Hook = RopeLease.Hook;
+	RopeLease = FSPRopeLease();
+	if (!IsValid(PoolActor) || !IsValid(Rope) || !IsValid(Hook))
+	{
+		return;
+	}
+
+	Rope->SetSimulationEnabled(false);
+	Rope->SetVisibility(false);
+	Hook->SetVisibility(false);
+	Rope->AttachToComponent(PoolActor->GetRootComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	Hook->AttachToComponent(PoolActor->GetRootComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+
+	FreeRopes.Add(Rope);
+	FreeHooks.Add(Hook);
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SPRopePoolSubsystem.generated.h"
+
+class UMaterialInterface;
+class UStaticMesh;
+class UStaticMeshComponent;
+class USPRopeComponent;
+
+// Rope with the hook its end is pinned to, both owned by the pool
+struct FSPRopeLease
+{
+	USPRopeComponent* Rope = nullptr;
+	UStaticMeshComponent* Hook = nullptr;
+
+	bool IsValid() const { return Rope != nullptr && Hook != nullptr; }
+};
+
+/**
+ * Rope and hook components shared by all characters of a world, a character only holds a pair while its rope is out.
+ * Returned pairs are hidden, which also takes the rope out of USPRopeSimulationSubsystem.
+ */
+UCLASS()
+class SWINGPROJ_API USPRopePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	FSPRopeLease Lease(UStaticMesh* HookStaticMesh, UMaterialInterface* RopeMaterial, float RopeWidth);
+	void Release(FSPRopeLease& RopeLease);
+
+	int32 GetNumLeased() const { return NumLeased; }
+	int32 GetNumPooled() const { return FreeRopes.Num(); }
+
+private:
+	UPROPERTY(Transient)
+	AActor* PoolActor;
+
+	UPROPERTY(Transient)
+	TArray<USPRopeComponent*> FreeRopes;
+
+	// Same order as FreeRopes
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> FreeHooks;
+
+	int32 NumLeased = 0;
+};
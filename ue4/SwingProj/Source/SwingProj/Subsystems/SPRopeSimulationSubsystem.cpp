@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPRopeSimulationSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/RopeComponents/SPRopeComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "SwingProj.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ropes at Full LOD"), STAT_RopesFullLOD, STATGROUP_Swing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ropes at Reduced LOD"), STAT_RopesReducedLOD, STATGROUP_Swing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ropes at Straight LOD"), STAT_RopesStraightLOD, STATGROUP_Swing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ropes Frozen"), STAT_RopesFrozen, STATGROUP_Swing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ropes at Rest"), STAT_RopesAtRest, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Rope Simulation"), STAT_SwingRopeSimulation, STATGROUP_Swing);
+
+void USPRopeSimulationSubsystem::RegisterRope(USPRopeComponent* Rope)
+{
+	Ropes.AddUnique(Rope);
+}
+
+void USPRopeSimulationSubsystem::UnregisterRope(USPRopeComponent* Rope)
+{
+	Ropes.RemoveSwap(Rope);
+}
+
+void USPRopeSimulationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_SWING_STAT(RopeSimulation);
+	Ropes.RemoveAllSwap([](const USPRopeComponent* Rope) { return !IsValid(Rope); });
+	GatherViewLocations();
+
+	uint32 NumRopesAtLOD[(int32)ESPRopeLOD::Num] = {};
+	uint32 NumRopesAtRest = 0;
+	SimulatedRopes.Reset();
+	UpdatedRopes.Reset();
+	for (USPRopeComponent* Rope : Ropes)
+	{
+		float ViewDistanceSquared = MAX_flt;
+		const FVector RopeLocation = Rope->GetComponentLocation();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ViewDistanceSquared = FMath::Min(ViewDistanceSquared, FVector::DistSquared(RopeLocation, ViewLocation));
+		}
+		Rope->UpdateLOD(ViewDistanceSquared);
+
+		const ESPRopeLOD RopeLOD = Rope->GetLOD();
+		NumRopesAtLOD[(int32)RopeLOD]++;
+
+		// Ropes at rest keep what the renderer already has
+		Rope->PreSimulate();
+		if (Rope->IsAtRest())
+		{
+			++NumRopesAtRest;
+			continue;
+		}
+
+		UpdatedRopes.Add(Rope);
+		if (RopeLOD == ESPRopeLOD::Full || RopeLOD == ESPRopeLOD::Reduced)
+		{
+			SimulatedRopes.Add(Rope);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_RopesFullLOD, NumRopesAtLOD[(int32)ESPRopeLOD::Full]);
+	SET_DWORD_STAT(STAT_RopesReducedLOD, NumRopesAtLOD[(int32)ESPRopeLOD::Reduced]);
+	SET_DWORD_STAT(STAT_RopesStraightLOD, NumRopesAtLOD[(int32)ESPRopeLOD::Straight]);
+	SET_DWORD_STAT(STAT_RopesFrozen, NumRopesAtLOD[(int32)ESPRopeLOD::Frozen]);
+	SET_DWORD_STAT(STAT_RopesAtRest, NumRopesAtRest);
+	CSV_CUSTOM_STAT(Swing, RopesFullLOD, (int32)NumRopesAtLOD[(int32)ESPRopeLOD::Full], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Swing, RopesReducedLOD, (int32)NumRopesAtLOD[(int32)ESPRopeLOD::Reduced], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Swing, RopesStraightLOD, (int32)NumRopesAtLOD[(int32)ESPRopeLOD::Straight], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Swing, RopesFrozen, (int32)NumRopesAtLOD[(int32)ESPRopeLOD::Frozen], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Swing, RopesAtRest, (int32)NumRopesAtRest, ECsvCustomStatOp::Set);
+
+	ParallelFor(SimulatedRopes.Num(), [this, DeltaTime](int32 Index)
+	{
+		SimulatedRopes[Index]->Simulate(DeltaTime);
+	});
+
+	for (USPRopeComponent* Rope : UpdatedRopes)
+	{
+		Rope->PostSimulate();
+	}
+}
+
+void USPRopeSimulationSubsystem::GatherViewLocations()
+{
+	ViewLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (IsValid(PlayerController) && PlayerController->IsLocalController() && IsValid(PlayerController->PlayerCameraManager))
+		{
+			ViewLocations.Add(PlayerController->PlayerCameraManager->GetCameraLocation());
+		}
+	}
+}
+
+ETickableTickType USPRopeSimulationSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool USPRopeSimulationSubsystem::IsTickable() const
+{
+	return Ropes.Num() > 0;
+}
+
+TStatId USPRopeSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USPRopeSimulationSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SPRopeSimulationSubsystem.generated.h"
+
+class USPRopeComponent;
+
+/**
+ * Steps every rope component of a game world once per frame, the solvers of different ropes run in parallel.
+ * Picks the LOD of every rope from its distance to the closest local player camera first, ropes at rest are skipped.
+ */
+UCLASS()
+class SWINGPROJ_API USPRopeSimulationSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterRope(USPRopeComponent* Rope);
+	void UnregisterRope(USPRopeComponent* Rope);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+private:
+	void GatherViewLocations();
+
+	UPROPERTY(Transient)
+	TArray<USPRopeComponent*> Ropes;
+
+	TArray<USPRopeComponent*> SimulatedRopes;
+	TArray<USPRopeComponent*> UpdatedRopes;
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+};
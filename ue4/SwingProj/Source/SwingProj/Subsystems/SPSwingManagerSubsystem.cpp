@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingManagerSubsystem.h"
+
+#include "Characters/SwingProjCharacter.h"
+#include "Components/MovementComponents/SPBaseCharacterMovementComponent.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "SwingProj.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Swingers"), STAT_Swingers, STATGROUP_Swing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Swingers Updated"), STAT_SwingersUpdated, STATGROUP_Swing);
+DECLARE_CYCLE_STAT(TEXT("Swing Manager"), STAT_SwingManager, STATGROUP_Swing);
+
+void USPSwingManagerSubsystem::RegisterSwinger(ASwingProjCharacter* Character)
+{
+	if (Swingers.Contains(Character))
+	{
+		return;
+	}
+
+	Swingers.Add(Character);
+	// Refreshed on the next tick whatever its relevancy
+	TimeSinceUpdate.Add(MAX_flt);
+	IsRelevant.Add(true);
+}
+
+void USPSwingManagerSubsystem::UnregisterSwinger(ASwingProjCharacter* Character)
+{
+	const int32 Index = Swingers.Find(Character);
+	if (Index != INDEX_NONE)
+	{
+		RemoveSwingerAt(Index);
+	}
+}
+
+void USPSwingManagerSubsystem::RemoveSwingerAt(int32 Index)
+{
+	Swingers.RemoveAtSwap(Index, 1, false);
+	TimeSinceUpdate.RemoveAtSwap(Index, 1, false);
+	IsRelevant.RemoveAtSwap(Index, 1, false);
+}
+
+void USPSwingManagerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_SWING_STAT(Manager);
+	FSPSwingAllocationScope AllocationScope;
+
+	for (int32 Index = Swingers.Num() - 1; Index >= 0; --Index)
+	{
+		if (!IsValid(Swingers[Index]) || !Swingers[Index]->IsSwinging())
+		{
+			RemoveSwingerAt(Index);
+		}
+	}
+
+	const bool bIsDedicatedServer = GetWorld()->GetNetMode() == NM_DedicatedServer;
+	if (bIsDedicatedServer)
+	{
+		TimeSinceRelevancyCheck += DeltaTime;
+		if (TimeSinceRelevancyCheck >= RelevancyCheckInterval)
+		{
+			TimeSinceRelevancyCheck = 0.f;
+			UpdateRelevancy();
+		}
+	}
+
+	// One subtraction per swinger, handing it to worker threads would cost more than the work
+	int32 NumUpdated = 0;
+	for (int32 Index = 0; Index < Swingers.Num(); ++Index)
+	{
+		TimeSinceUpdate[Index] += DeltaTime;
+		if (!bIsDedicatedServer || IsRelevant[Index] || TimeSinceUpdate[Index] >= IrrelevantUpdateInterval)
+		{
+			ASwingProjCharacter* Character = Swingers[Index];
+			Character->SetCurrentRopeVector(Character->GetBaseCharacterMovementComponent()->GetSwingPivotLocation() - Character->GetActorLocation());
+			TimeSinceUpdate[Index] = 0.f;
+			NumUpdated++;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_Swingers, Swingers.Num());
+	SET_DWORD_STAT(STAT_SwingersUpdated, NumUpdated);
+}
+
+void USPSwingManagerSubsystem::UpdateRelevancy()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (NetDriver == nullptr)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < Swingers.Num(); ++Index)
+	{
+		IsRelevant[Index] = false;
+	}
+
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection == nullptr || !IsValid(Connection->PlayerController))
+		{
+			continue;
+		}
+
+		const AActor* ViewTarget = IsValid(Connection->ViewTarget) ? Connection->ViewTarget : Connection->PlayerController;
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Connection->PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		for (int32 Index = 0; Index < Swingers.Num(); ++Index)
+		{
+			if (!IsRelevant[Index])
+			{
+				IsRelevant[Index] = Swingers[Index]->IsNetRelevantFor(Connection->PlayerController, ViewTarget, ViewLocation);
+			}
+		}
+	}
+}
+
+ETickableTickType USPSwingManagerSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool USPSwingManagerSubsystem::IsTickable() const
+{
+	return Swingers.Num() > 0;
+}
+
+TStatId USPSwingManagerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USPSwingManagerSubsystem, STATGROUP_Tickables);
+}
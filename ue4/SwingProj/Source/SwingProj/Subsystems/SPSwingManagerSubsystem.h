@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SPSwingManagerSubsystem.generated.h"
+
+class ASwingProjCharacter;
+
+/**
+ * Refreshes the rope direction of every swinging character in one pass, characters that do not swing cost nothing.
+ * On a dedicated server characters not relevant to any connection are refreshed at a reduced rate.
+ */
+UCLASS(config = Game)
+class SWINGPROJ_API USPSwingManagerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterSwinger(ASwingProjCharacter* Character);
+	void UnregisterSwinger(ASwingProjCharacter* Character);
+
+	int32 GetNumSwingers() const { return Swingers.Num(); }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	// Dedicated server only, seconds between two refreshes of a swinger no connection is interested in
+	UPROPERTY(Config)
+	float IrrelevantUpdateInterval = 0.25f;
+
+	UPROPERTY(Config)
+	float RelevancyCheckInterval = 0.5f;
+
+private:
+	void RemoveSwingerAt(int32 Index);
+	void UpdateRelevancy();
+
+	// Parallel arrays, indexed like Swingers
+	UPROPERTY(Transient)
+	TArray<ASwingProjCharacter*> Swingers;
+
+	TArray<float> TimeSinceUpdate;
+	TArray<bool> IsRelevant;
+
+	float TimeSinceRelevancyCheck = 0.f;
+};
@@ -8,7 +8,9 @@ public class SwingProj : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "CableComponent" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "AIModule" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "RenderCore", "RHI" });
 		
 		PrivateIncludePaths.AddRange(new string[] { Name });
 	}
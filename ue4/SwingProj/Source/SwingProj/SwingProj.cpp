@@ -1,7 +1,26 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SwingProj.h"
+#include "Benchmark/SPCountingMalloc.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, SwingProj, "SwingProj" );
- 
\ No newline at end of file
+CSV_DEFINE_CATEGORY_MODULE(SWINGPROJ_API, Swing, true);
+
+UE_TRACE_CHANNEL_DEFINE(SwingChannel);
+
+class FSwingProjModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		// Swapped while the game is still loading, before any gameplay code allocates through it
+		if (FParse::Param(FCommandLine::Get(), TEXT("SwingCountAllocations")))
+		{
+			FSPCountingMalloc::Install();
+		}
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FSwingProjModule, SwingProj, "SwingProj" );
@@ -3,3 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+DECLARE_STATS_GROUP(TEXT("Swing"), STATGROUP_Swing, STATCAT_Advanced);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SWINGPROJ_API, Swing);
+
+UE_TRACE_CHANNEL_EXTERN(SwingChannel, SWINGPROJ_API);
+
+// Names a scope in stat, in CSV captures and on the Swing trace channel at once, STAT_Swing<Name> has to be declared in the same file
+#define SCOPE_SWING_STAT(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_Swing##Name); \
+	CSV_SCOPED_TIMING_STAT(Swing, Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Swing##Name, SwingChannel)
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPSwingTelemetry.h"
+
+#include "Containers/CircularQueue.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSwingTelemetry, Log, All);
+
+namespace SPSwingTelemetry
+{
+	// About a second of a hundred swinging characters at 60 fps
+	static constexpr uint32 QueueCapacity = 8192;
+	static constexpr int32 MaxRecordsPerWrite = 1024;
+	static constexpr float IdleSleepTime = 0.005f;
+}
+
+class FSPSwingTelemetryWriter : public FRunnable
+{
+public:
+	explicit FSPSwingTelemetryWriter(FArchive* InFileWriter)
+		: Queue(SPSwingTelemetry::QueueCapacity)
+		, FileWriter(InFileWriter)
+	{
+	}
+
+	virtual ~FSPSwingTelemetryWriter() override
+	{
+		delete FileWriter;
+	}
+
+	void Enqueue(const FSPSwingTelemetryRecord& Record)
+	{
+		if (Queue.Enqueue(Record))
+		{
+			++NumRecords;
+		}
+		else
+		{
+			++NumDroppedRecords;
+		}
+	}
+
+	virtual uint32 Run() override
+	{
+		while (!bStopping)
+		{
+			if (!WriteQueuedRecords())
+			{
+				FPlatformProcess::Sleep(SPSwingTelemetry::IdleSleepTime);
+			}
+		}
+
+		// The producer has stopped by now, whatever is left in the queue is final
+		while (WriteQueuedRecords())
+		{
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+	}
+
+	uint64 GetNumRecords() const { return NumRecords; }
+	uint64 GetNumDroppedRecords() const { return NumDroppedRecords; }
+
+private:
+	bool WriteQueuedRecords()
+	{
+		FSPSwingTelemetryRecord Record;
+		int32 NumWritten = 0;
+		while (NumWritten < SPSwingTelemetry::MaxRecordsPerWrite && Queue.Dequeue(Record))
+		{
+			uint8 Event = (uint8)Record.Event;
+			*FileWriter << Record.Cycles << Record.Frame << Record.CharacterId << Record.AnchorId << Event;
+			*FileWriter << Record.Values[0] << Record.Values[1] << Record.Values[2];
+			++NumWritten;
+		}
+		return NumWritten > 0;
+	}
+
+	TCircularQueue<FSPSwingTelemetryRecord> Queue;
+	FArchive* FileWriter;
+	TAtomic<bool> bStopping { false };
+
+	// Producer side only
+	uint64 NumRecords = 0;
+	uint64 NumDroppedRecords = 0;
+};
+
+namespace SPSwingTelemetry
+{
+	static FSPSwingTelemetryWriter* Writer = nullptr;
+	static FRunnableThread* WriterThread = nullptr;
+}
+
+bool FSPSwingTelemetry::bIsCapturing = false;
+
+void FSPSwingTelemetry::Push(ESPSwingTelemetryEvent Event, uint32 CharacterId, uint32 AnchorId, float Value0, float Value1, float Value2)
+{
+	checkSlow(IsInGameThread());
+	if (!bIsCapturing)
+	{
+		return;
+	}
+
+	FSPSwingTelemetryRecord Record;
+	Record.Cycles = FPlatformTime::Cycles64();
+	Record.Frame = (uint32)GFrameCounter;
+	Record.CharacterId = CharacterId;
+	Record.AnchorId = AnchorId;
+	Record.Event = Event;
+	Record.Values[0] = Value0;
+	Record.Values[1] = Value1;
+	Record.Values[2] = Value2;
+	SPSwingTelemetry::Writer->Enqueue(Record);
+}
+
+bool FSPSwingTelemetry::StartCapture(const FString& FilePath)
+{
+	StopCapture();
+
+	FArchive* FileWriter = IFileManager::Get().CreateFileWriter(*FilePath);
+	if (FileWriter == nullptr)
+	{
+		UE_LOG(LogSwingTelemetry, Error, TEXT("Can't open %s for swing telemetry"), *FilePath);
+		return false;
+	}
+
+	uint32 FileMagic = Magic;
+	uint32 FileVersion = Version;
+	double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	*FileWriter << FileMagic << FileVersion << SecondsPerCycle;
+
+	static bool bStopOnExitRegistered = false;
+	if (!bStopOnExitRegistered)
+	{
+		bStopOnExitRegistered = true;
+		FCoreDelegates::OnPreExit.AddStatic(&FSPSwingTelemetry::StopCapture);
+	}
+
+	SPSwingTelemetry::Writer = new FSPSwingTelemetryWriter(FileWriter);
+	SPSwingTelemetry::WriterThread = FRunnableThread::Create(SPSwingTelemetry::Writer, TEXT("SwingTelemetryWriter"), 0, TPri_BelowNormal);
+	bIsCapturing = true;
+	UE_LOG(LogSwingTelemetry, Display, TEXT("Capturing swing telemetry to %s"), *FilePath);
+	return true;
+}
+
+void FSPSwingTelemetry::StopCapture()
+{
+	if (!bIsCapturing)
+	{
+		return;
+	}
+
+	bIsCapturing = false;
+	SPSwingTelemetry::WriterThread->Kill(true);
+	delete SPSwingTelemetry::WriterThread;
+	SPSwingTelemetry::WriterThread = nullptr;
+
+	UE_LOG(LogSwingTelemetry, Display, TEXT("Swing telemetry stopped: %llu records written, %llu dropped"),
+		SPSwingTelemetry::Writer->GetNumRecords(), SPSwingTelemetry::Writer->GetNumDroppedRecords());
+	delete SPSwingTelemetry::Writer;
+	SPSwingTelemetry::Writer = nullptr;
+}
+
+static FAutoConsoleCommand SwingTelemetryStartCommand(
+	TEXT("Swing.Telemetry.Start"),
+	TEXT("Starts capturing swing telemetry to [FileName], a timestamped file under Saved/Telemetry by default"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString FileName = Args.Num() > 0 ? Args[0] : FString::Printf(TEXT("SwingTelemetry_%s.bin"), *FDateTime::Now().ToString());
+		FSPSwingTelemetry::StartCapture(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"), FileName));
+	}));
+
+static FAutoConsoleCommand SwingTelemetryStopCommand(
+	TEXT("Swing.Telemetry.Stop"),
+	TEXT("Stops the swing telemetry capture and closes its file"),
+	FConsoleCommandDelegate::CreateStatic(&FSPSwingTelemetry::StopCapture));
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ESPSwingTelemetryEvent : uint8
+{
+	// Values: free rope length, velocity change applied by the rope, speed
+	SwingStep,
+	// Values: rope length
+	RopeAttached,
+	// Values: speed
+	RopeDetached,
+	// Values: score, distance to the anchor, number of candidates
+	AnchorSelected
+};
+
+struct FSPSwingTelemetryRecord
+{
+	uint64 Cycles = 0;
+	uint32 Frame = 0;
+	uint32 CharacterId = 0;
+	uint32 AnchorId = 0;
+	ESPSwingTelemetryEvent Event = ESPSwingTelemetryEvent::SwingStep;
+	float Values[3] = {};
+};
+
+/**
+ * Swing metrics captured to a binary file under Saved/Telemetry, started and stopped with Swing.Telemetry.Start and Swing.Telemetry.Stop.
+ * Game thread producers push fixed size records into a lock-free single producer queue, a background thread writes them out.
+ * Records are dropped, and counted, while the queue is full.
+ */
+class SWINGPROJ_API FSPSwingTelemetry
+{
+public:
+	static constexpr uint32 Magic = 0x4C545053;
+	static constexpr uint32 Version = 2;
+
+	// Check before gathering the values of a record, capture is off most of the time
+	static bool IsCapturing() { return bIsCapturing; }
+
+	// Game thread only. Ids are the actors' precomputed stable ids, a record only copies values into the queue
+	static void Push(ESPSwingTelemetryEvent Event, uint32 CharacterId, uint32 AnchorId, float Value0, float Value1 = 0.f, float Value2 = 0.f);
+
+	static bool StartCapture(const FString& FilePath);
+	static void StopCapture();
+
+private:
+	static bool bIsCapturing;
+};